@@ -31,9 +31,29 @@ SOFTWARE.
 #define CVEC_H
 
 #include <stddef.h> /* for size_t */
+#include <stdbool.h> /* for bool */
+#include <stdint.h> /* for uint64_t, int64_t */
+#include <string.h> /* for memcpy, memmove */
 
 /** Opaque handle for the vector object. */
-typedef struct cvec cvec_t;
+typedef struct cvec_vector cvec_t;
+
+/** The first member of every vector object.
+ * \details It is public so that wrappers (see cvec.hpp) can read the data
+ * and the length inline. Vectors must still only be modified through the 
+ * functions of the library. */
+struct cvec_layout {
+	/** Pointer to the vector data. */
+	void *data;
+
+	/** The current length of the vector. */
+	size_t len;
+
+	/** The reference count (an atomic size_t) of data shared with 
+	 * snapshots or NULL. While it is set, cvec_data_ptr has to be called 
+	 * before writing. */
+	void *shared;
+};
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,6 +70,38 @@ size_t cvec_default_capacity();
  * \return A pointer to the allocated vector. */
 cvec_t *cvec_new(size_t sizeof_type);
 
+/** Creates a new pointer for a specific type with aligned data.
+ * \param sizeof_type The size of the type that's meant to be stored 
+ * in the vector.
+ * \param alignment The alignment of the data (a power of two or 0 for
+ * the allocator's default). It is kept across every reallocation.
+ * \return A pointer to the allocated vector. */
+cvec_t *cvec_new_aligned(size_t sizeof_type, size_t alignment);
+
+/** Opts a vector in or out of transparent huge pages.
+ * \details When enabled, every buffer of at least 2 MiB the vector 
+ * allocates is advised with madvise(MADV_HUGEPAGE). This is a hint that
+ * does nothing on systems without transparent huge pages.
+ * \param vec A pointer to the vector to be modified.
+ * \param enable Whether huge pages should be requested. */
+void cvec_set_huge_pages(cvec_t *vec, bool enable);
+
+/** Creates a deep copy of a vector.
+ * \param vec A pointer to the vector to be copied.
+ * \return A pointer to the allocated copy. */
+cvec_t *cvec_clone(const cvec_t *vec);
+
+/** Creates a copy-on-write snapshot of a vector in O(1).
+ * \details The snapshot shares the data of the vector. Whichever of them 
+ * is modified first (including through cvec_ptr) gets a private copy of 
+ * the data. Taking the snapshot must not race with modifications of vec.
+ * Afterwards another thread may read the snapshot while vec is modified,
+ * but the memory comes from the thread-local allocator, so both handles 
+ * must be modified and deleted on the thread that created vec.
+ * \param vec A pointer to the vector to be snapshotted.
+ * \return A pointer to the allocated snapshot. */
+cvec_t *cvec_snapshot(cvec_t *vec);
+
 /** Returns the the length of a vector.
  * \param vec A pointer to the vector to be accessed. 
  * \return The length of the vector or (size_t)-1 on failure. */
@@ -81,6 +133,20 @@ const void *cvec_view(const cvec_t *vec, size_t index);
  * \return A pointer to the item. */
 void *cvec_ptr(cvec_t *vec, size_t index);
 
+/** Returns a const pointer to the first item of a vector.
+ * \details Unlike cvec_view this also works on an empty vector. The 
+ * pointer is invalidated by any function that modifies the vector.
+ * \param vec A pointer to the vector to be accessed.
+ * \return A const pointer to the data. */
+const void *cvec_data_view(const cvec_t *vec);
+
+/** Returns a pointer to the first item of a vector.
+ * \details Unlike cvec_ptr this also works on an empty vector. The 
+ * pointer is invalidated by any function that modifies the vector.
+ * \param vec A pointer to the vector to be accessed.
+ * \return A pointer to the data. */
+void *cvec_data_ptr(cvec_t *vec);
+
 /** Append an item at the end of the vector.
  * \param vec A pointer to the vector to be modified.
  * \param value A pointer to the value to be appended.
@@ -152,15 +218,359 @@ void cvec_replace_range(
 	cvec_t *vec, size_t index, void *arr,
 	size_t len, size_t range, size_t sizeof_type);
 
+/** Sets the length of a vector, filling new items with a value.
+ * \details The vector is reallocated at most once. Buffers above 
+ * CVEC_PARALLEL_THRESHOLD bytes (64 MiB by default) are filled by several
+ * threads, each touching its own part of the buffer first.
+ * \param vec A pointer to the vector to be modified.
+ * \param len The new length.
+ * \param fill_value A pointer to the value of the new items 
+ * (NULL for zeroes).
+ * \param sizeof_type The size of the vector's type 
+ * (must be the same as the value's). */
+void cvec_resize(cvec_t *vec, size_t len, void *fill_value, size_t sizeof_type);
+
+/** Replaces the contents of a vector with copies of a value.
+ * \param vec A pointer to the vector to be modified.
+ * \param len The new length.
+ * \param value A pointer to the value of the items (NULL for zeroes).
+ * \param sizeof_type The size of the vector's type 
+ * (must be the same as the value's). */
+void cvec_assign(cvec_t *vec, size_t len, void *value, size_t sizeof_type);
+
+/** Overwrites a range of items of a vector with copies of a value.
+ * \param vec A pointer to the vector to be modified.
+ * \param index The index of the first item to be overwritten.
+ * \param len The number of items to be overwritten.
+ * \param value A pointer to the value of the items (NULL for zeroes).
+ * \param sizeof_type The size of the vector's type 
+ * (must be the same as the value's). */
+void cvec_fill_range(
+	cvec_t *vec, size_t index, size_t len, void *value, size_t sizeof_type);
+
+/** Replaces the contents of a vector with items selected from another one.
+ * \details Afterwards dst[i] is src[idx[i]] for every i below len. Items 
+ * ahead are prefetched and large gathers run on several threads. 
+ * \param dst A pointer to the vector to be overwritten.
+ * \param src A pointer to the vector to be selected from (must be a 
+ * different vector of the same type).
+ * \param idx The indices of the selected items (may repeat).
+ * \param len The number of indices. */
+void cvec_gather(cvec_t *dst, const cvec_t *src, const size_t *idx, size_t len);
+
+/** Writes the items of a vector to given positions of another one.
+ * \details Afterwards dst[idx[i]] is src[i] for every i below the length
+ * of src. Items ahead are prefetched and large scatters run on several 
+ * threads. 
+ * \param dst A pointer to the vector to be written to.
+ * \param src A pointer to the vector to be read from (must be a different 
+ * vector of the same type).
+ * \param idx The positions in dst, one for each item of src. They should 
+ * be distinct; which item ends up at a repeated position is unspecified. */
+void cvec_scatter(cvec_t *dst, const cvec_t *src, const size_t *idx);
+
+/** Reorders the items of a vector.
+ * \details Afterwards vec[i] is the former vec[perm[i]] for every i below 
+ * the length of the vector. The items are gathered into a new buffer that
+ * replaces the old one. 
+ * \param vec A pointer to the vector to be reordered.
+ * \param perm One index per item (typically a permutation, as returned by
+ * an argsort). */
+void cvec_permute(cvec_t *vec, const size_t *perm);
+
 /** Returns a string containing the latest error information if exists or 
  * NULL if it does not. */
 const char *cvec_get_error();
 
+/** Sets the limits of the calling thread's buffer cache.
+ * \details The cache recycles the headers and data buffers of deleted and 
+ * resized vectors in power of two size classes, so that creating and 
+ * deleting many short-lived vectors does not reach the allocator. It is
+ * disabled until this function is called with a nonzero max_bytes. 
+ * Blocks already cached above the new limits are freed, and the remaining
+ * ones are freed when the thread exits.
+ * \param max_bytes The maximum total size of the cached blocks 
+ * (0 disables the cache).
+ * \param max_blocks The maximum number of cached blocks per size class. */
+void cvec_cache_set_limits(size_t max_bytes, size_t max_blocks);
+
+/** Frees every block cached by the calling thread.
+ * \details This also happens automatically when the thread exits. */
+void cvec_cache_trim();
+
+/** Returns the total size of the blocks cached by the calling thread.
+ * \return The size in bytes. */
+size_t cvec_cache_size();
+
+/** Opaque handle for the bit vector object. */
+typedef struct cvec_bits cvec_bits_t;
+
+/** Creates a new, empty bit vector.
+ * \return A pointer to the allocated bit vector. */
+cvec_bits_t *cvec_bits_new();
+
+/** Deletes a bit vector instance.
+ * \param bits A pointer to the bit vector to be deleted. */
+void cvec_bits_del(cvec_bits_t *bits);
+
+/** Returns the number of bits in a bit vector.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \return The number of bits or (size_t)-1 on failure. */
+size_t cvec_bits_len(const cvec_bits_t *bits);
+
+/** Appends a bit at the end of a bit vector.
+ * \param bits A pointer to the bit vector to be modified.
+ * \param value The value of the bit. */
+void cvec_bits_push_back(cvec_bits_t *bits, bool value);
+
+/** Removes the last bit of a bit vector.
+ * \param bits A pointer to the bit vector to be modified. */
+void cvec_bits_pop_back(cvec_bits_t *bits);
+
+/** Returns the value of a bit.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \param index The index of the bit.
+ * \return The value of the bit (false on failure). */
+bool cvec_bits_get(const cvec_bits_t *bits, size_t index);
+
+/** Sets the value of a bit.
+ * \param bits A pointer to the bit vector to be modified.
+ * \param index The index of the bit.
+ * \param value The new value of the bit. */
+void cvec_bits_set(cvec_bits_t *bits, size_t index, bool value);
+
+/** Appends packed bits at the end of a bit vector.
+ * \param bits A pointer to the bit vector to be modified.
+ * \param words The bits to be appended, packed least significant bit first.
+ * \param len The number of bits to be appended. */
+void cvec_bits_append(cvec_bits_t *bits, const uint64_t *words, size_t len);
+
+/** Returns a pointer to the packed words of a bit vector.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \return A const pointer to the words, least significant bit first. */
+const uint64_t *cvec_bits_words(const cvec_bits_t *bits);
+
+/** Returns the number of set bits in a bit vector.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \return The number of set bits or (size_t)-1 on failure. */
+size_t cvec_bits_popcount(const cvec_bits_t *bits);
+
+/** Returns the index of the first set bit.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \return The index of the set bit or (size_t)-1 if there is none. */
+size_t cvec_bits_find_first_set(const cvec_bits_t *bits);
+
+/** Returns the index of the first set bit at or after a given index.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \param index The index the search starts from.
+ * \return The index of the set bit or (size_t)-1 if there is none. */
+size_t cvec_bits_find_next_set(const cvec_bits_t *bits, size_t index);
+
+/** Returns the number of set bits before a given index.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \param index The index (may be equal to the length).
+ * \return The number of set bits or (size_t)-1 on failure. */
+size_t cvec_bits_rank(const cvec_bits_t *bits, size_t index);
+
+/** Returns the index of the nth (0-based) set bit.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \param n The rank of the set bit.
+ * \return The index of the set bit or (size_t)-1 if there is none. */
+size_t cvec_bits_select(const cvec_bits_t *bits, size_t n);
+
+/** Sets dst to the bitwise AND of dst and src.
+ * \param dst A pointer to the bit vector to be modified.
+ * \param src A pointer to a bit vector of the same length. */
+void cvec_bits_and(cvec_bits_t *dst, const cvec_bits_t *src);
+
+/** Sets dst to the bitwise OR of dst and src.
+ * \param dst A pointer to the bit vector to be modified.
+ * \param src A pointer to a bit vector of the same length. */
+void cvec_bits_or(cvec_bits_t *dst, const cvec_bits_t *src);
+
+/** Sets dst to the bitwise XOR of dst and src.
+ * \param dst A pointer to the bit vector to be modified.
+ * \param src A pointer to a bit vector of the same length. */
+void cvec_bits_xor(cvec_bits_t *dst, const cvec_bits_t *src);
+
+/** Clears the bits of dst that are set in src.
+ * \param dst A pointer to the bit vector to be modified.
+ * \param src A pointer to a bit vector of the same length. */
+void cvec_bits_andnot(cvec_bits_t *dst, const cvec_bits_t *src);
+
+/** The number of values per block of a compressed vector. */
+#define CVEC_COMPRESSED_BLOCK_LEN 128
+
+/** Opaque handle for the compressed integer vector object. */
+typedef struct cvec_compressed cvec_compressed_t;
+
+/** Compresses a vector of int64_t.
+ * \details The values are stored in blocks of CVEC_COMPRESSED_BLOCK_LEN,
+ * each bit-packed as offsets from its minimum or as deltas between 
+ * neighbouring values, whichever is smaller. Sorted or clustered values 
+ * compress best.
+ * \param vec A pointer to the vector to be compressed.
+ * \return A pointer to the allocated compressed vector. */
+cvec_compressed_t *cvec_compress(const cvec_t *vec);
+
+/** Decompresses a compressed vector into a new vector of int64_t.
+ * \param c A pointer to the compressed vector to be decompressed.
+ * \return A pointer to the allocated vector. */
+cvec_t *cvec_decompress(const cvec_compressed_t *c);
+
+/** Deletes a compressed vector instance.
+ * \param c A pointer to the compressed vector to be deleted. */
+void cvec_compressed_del(cvec_compressed_t *c);
+
+/** Returns the number of values in a compressed vector.
+ * \param c A pointer to the compressed vector to be accessed.
+ * \return The number of values or (size_t)-1 on failure. */
+size_t cvec_compressed_len(const cvec_compressed_t *c);
+
+/** Returns the number of bytes a compressed vector occupies.
+ * \param c A pointer to the compressed vector to be accessed.
+ * \return The number of bytes or (size_t)-1 on failure. */
+size_t cvec_compressed_bytes(const cvec_compressed_t *c);
+
+/** Returns a value of a compressed vector.
+ * \param c A pointer to the compressed vector to be accessed.
+ * \param index The index of the value.
+ * \return The value (0 on failure). */
+int64_t cvec_compressed_get(const cvec_compressed_t *c, size_t index);
+
+/** Decodes a range of values of a compressed vector.
+ * \details Decoding is fastest when index is a multiple of 
+ * CVEC_COMPRESSED_BLOCK_LEN, which is what sequential iteration with a
+ * buffer of that many values does.
+ * \param c A pointer to the compressed vector to be accessed.
+ * \param index The index of the first value to be decoded.
+ * \param out The array receiving the values.
+ * \param len The maximum number of values to be decoded.
+ * \return The number of values decoded (0 at the end or on failure). */
+size_t cvec_compressed_decode(
+	const cvec_compressed_t *c, size_t index, int64_t *out, size_t len);
+
+/** Opaque handle for the hash map object. */
+typedef struct cvec_map cvec_map_t;
+
+/** Hash function used by the hash map.
+ * \param key A pointer to the key to be hashed.
+ * \return The hash of the key. */
+typedef size_t (*cvec_map_hash_fn)(const void *key);
+
+/** Equality function used by the hash map.
+ * \param a A pointer to the first key.
+ * \param b A pointer to the second key.
+ * \return true if the keys are equal. */
+typedef bool (*cvec_map_eq_fn)(const void *a, const void *b);
+
+/** Creates a new open-addressing hash map for specific key and value types.
+ * \param sizeof_key The size of the key type.
+ * \param sizeof_value The size of the value type (0 for a hash set).
+ * \param hash The hash function or NULL to hash the bytes of the key.
+ * \param eq The equality function or NULL to compare the bytes of the key.
+ * \return A pointer to the allocated hash map. */
+cvec_map_t *cvec_map_new(
+	size_t sizeof_key, size_t sizeof_value,
+	cvec_map_hash_fn hash, cvec_map_eq_fn eq);
+
+/** Deletes a hash map instance.
+ * \param map A pointer to the hash map to be deleted. */
+void cvec_map_del(cvec_map_t *map);
+
+/** Returns the number of entries in a hash map.
+ * \param map A pointer to the hash map to be accessed.
+ * \return The number of entries or (size_t)-1 on failure. */
+size_t cvec_map_len(const cvec_map_t *map);
+
+/** Returns the number of slots in a hash map.
+ * \param map A pointer to the hash map to be accessed.
+ * \return The number of slots or (size_t)-1 on failure. */
+size_t cvec_map_capacity(const cvec_map_t *map);
+
+/** Makes room for at least len entries without further rehashing.
+ * \param map A pointer to the hash map to be modified.
+ * \param len The number of entries to make room for. */
+void cvec_map_reserve(cvec_map_t *map, size_t len);
+
+/** Rebuilds a hash map with at least the requested number of slots.
+ * \details This also drops every tombstone left behind by removals.
+ * \param map A pointer to the hash map to be modified.
+ * \param capacity The requested number of slots. */
+void cvec_map_rehash(cvec_map_t *map, size_t capacity);
+
+/** Inserts an entry or replaces the value of an existing one.
+ * \param map A pointer to the hash map to be modified.
+ * \param key A pointer to the key.
+ * \param value A pointer to the value (ignored for a hash set).
+ * \param sizeof_key The size of the map's key type.
+ * \param sizeof_value The size of the map's value type.
+ * \return true if the key was not yet present in the map. */
+bool cvec_map_insert(
+	cvec_map_t *map, const void *key, const void *value,
+	size_t sizeof_key, size_t sizeof_value);
+
+/** Checks whether a key is present in a hash map.
+ * \param map A pointer to the hash map to be accessed.
+ * \param key A pointer to the key to be looked up.
+ * \return true if the key is present. */
+bool cvec_map_contains(const cvec_map_t *map, const void *key);
+
+/** Returns a const pointer to the value stored under a key.
+ * \param map A pointer to the hash map to be accessed.
+ * \param key A pointer to the key to be looked up.
+ * \return A const pointer to the value or NULL if the key is not present. */
+const void *cvec_map_view(const cvec_map_t *map, const void *key);
+
+/** Returns a pointer to the value stored under a key.
+ * \param map A pointer to the hash map to be accessed.
+ * \param key A pointer to the key to be looked up.
+ * \return A pointer to the value or NULL if the key is not present. */
+void *cvec_map_ptr(cvec_map_t *map, const void *key);
+
+/** Removes an entry from a hash map.
+ * \param map A pointer to the hash map to be modified.
+ * \param key A pointer to the key to be removed.
+ * \return true if the key was present. */
+bool cvec_map_remove(cvec_map_t *map, const void *key);
+
+/** Removes every entry from a hash map while keeping its slots.
+ * \param map A pointer to the hash map to be modified. */
+void cvec_map_clear(cvec_map_t *map);
+
+/** Steps through the entries of a hash map in slot order.
+ * \param map A pointer to the hash map to be accessed.
+ * \param iter A pointer to the iterator (must be 0 before the first call).
+ * \param key Receives a const pointer to the key of the entry.
+ * \param value Receives a const pointer to the value of the entry 
+ * (may be NULL).
+ * \return false once there are no more entries. */
+bool cvec_map_next(
+	const cvec_map_t *map, size_t *iter, const void **key, const void **value);
+
+/** Removes duplicate items from a vector keeping their first occurrence.
+ * \param vec A pointer to the vector to be modified.
+ * \param hash The hash function or NULL to hash the bytes of the items.
+ * \param eq The equality function or NULL to compare the bytes of the items. */
+void cvec_dedup(cvec_t *vec, cvec_map_hash_fn hash, cvec_map_eq_fn eq);
+
 #define CVEC_TYPEDEF(T)\
 	typedef struct v##T v##T;\
 	static inline v##T *v##T##_new() {\
 		return (v##T*)cvec_new(sizeof(T));\
 	}\
+	static inline v##T *v##T##_new_aligned(size_t alignment) {\
+		return (v##T*)cvec_new_aligned(sizeof(T), alignment);\
+	}\
+	static inline void v##T##_set_huge_pages(v##T *vec, bool enable) {\
+		cvec_set_huge_pages((cvec_t*)vec, enable);\
+	}\
+	static inline v##T *v##T##_clone(const v##T *vec) {\
+		return (v##T*)cvec_clone((cvec_t*)vec);\
+	}\
+	static inline v##T *v##T##_snapshot(v##T *vec) {\
+		return (v##T*)cvec_snapshot((cvec_t*)vec);\
+	}\
 	static inline size_t v##T##_len(const v##T *vec) {\
 		return cvec_len((cvec_t*)vec);\
 	}\
@@ -208,6 +618,202 @@ const char *cvec_get_error();
 	}\
 	static inline void v##T##_replace_range(v##T *vec, size_t index, T *arr, size_t len, size_t range) {\
 		cvec_replace_range((cvec_t*)vec, index, (void*)arr, len, range, sizeof(T));\
+	}\
+	static inline void v##T##_resize(v##T *vec, size_t len, T fill_value) {\
+		cvec_resize((cvec_t*)vec, len, (void*)&fill_value, sizeof(T));\
+	}\
+	static inline void v##T##_assign(v##T *vec, size_t len, T value) {\
+		cvec_assign((cvec_t*)vec, len, (void*)&value, sizeof(T));\
+	}\
+	static inline void v##T##_fill_range(v##T *vec, size_t index, size_t len, T value) {\
+		cvec_fill_range((cvec_t*)vec, index, len, (void*)&value, sizeof(T));\
+	}\
+	static inline void v##T##_gather(v##T *dst, const v##T *src, const size_t *idx, size_t len) {\
+		cvec_gather((cvec_t*)dst, (const cvec_t*)src, idx, len);\
+	}\
+	static inline void v##T##_scatter(v##T *dst, const v##T *src, const size_t *idx) {\
+		cvec_scatter((cvec_t*)dst, (const cvec_t*)src, idx);\
+	}\
+	static inline void v##T##_permute(v##T *vec, const size_t *perm) {\
+		cvec_permute((cvec_t*)vec, perm);\
+	}
+
+#define CVEC_STATIC_TYPEDEF(T, N)\
+	typedef struct sv##T##_##N {\
+		size_t len;\
+		T data[N];\
+	} sv##T##_##N;\
+	static inline void sv##T##_##N##_init(sv##T##_##N *vec) {\
+		vec->len = 0;\
+	}\
+	static inline size_t sv##T##_##N##_len(const sv##T##_##N *vec) {\
+		return vec->len;\
+	}\
+	static inline size_t sv##T##_##N##_size(const sv##T##_##N *vec) {\
+		(void)vec;\
+		return sizeof(T);\
+	}\
+	static inline size_t sv##T##_##N##_capacity(const sv##T##_##N *vec) {\
+		(void)vec;\
+		return (N);\
+	}\
+	static inline const T *sv##T##_##N##_view(const sv##T##_##N *vec, size_t index) {\
+		return index < vec->len ? &vec->data[index] : NULL;\
+	}\
+	static inline T *sv##T##_##N##_ptr(sv##T##_##N *vec, size_t index) {\
+		return index < vec->len ? &vec->data[index] : NULL;\
+	}\
+	static inline bool sv##T##_##N##_push_back(sv##T##_##N *vec, T value) {\
+		if (vec->len >= (N))\
+			return false;\
+		vec->data[vec->len++] = value;\
+		return true;\
+	}\
+	static inline bool sv##T##_##N##_pop_back(sv##T##_##N *vec) {\
+		if (!vec->len)\
+			return false;\
+		vec->len--;\
+		return true;\
+	}\
+	static inline bool sv##T##_##N##_push_front(sv##T##_##N *vec, T value) {\
+		if (vec->len >= (N))\
+			return false;\
+		memmove(&vec->data[1], vec->data, vec->len * sizeof(T));\
+		vec->data[0] = value;\
+		vec->len++;\
+		return true;\
+	}\
+	static inline bool sv##T##_##N##_pop_front(sv##T##_##N *vec) {\
+		if (!vec->len)\
+			return false;\
+		vec->len--;\
+		memmove(vec->data, &vec->data[1], vec->len * sizeof(T));\
+		return true;\
+	}\
+	static inline bool sv##T##_##N##_append(sv##T##_##N *vec, const T *arr, size_t len) {\
+		if (len > (N) - vec->len)\
+			return false;\
+		memcpy(&vec->data[vec->len], arr, len * sizeof(T));\
+		vec->len += len;\
+		return true;\
+	}\
+	static inline bool sv##T##_##N##_prepend(sv##T##_##N *vec, const T *arr, size_t len) {\
+		if (len > (N) - vec->len)\
+			return false;\
+		memmove(&vec->data[len], vec->data, vec->len * sizeof(T));\
+		memcpy(vec->data, arr, len * sizeof(T));\
+		vec->len += len;\
+		return true;\
+	}\
+	static inline bool sv##T##_##N##_remove(sv##T##_##N *vec, size_t index) {\
+		if (index >= vec->len)\
+			return false;\
+		vec->len--;\
+		memmove(&vec->data[index], &vec->data[index + 1], (vec->len - index) * sizeof(T));\
+		return true;\
+	}\
+	static inline bool sv##T##_##N##_insert(sv##T##_##N *vec, T value, size_t index) {\
+		if (index >= vec->len || vec->len >= (N))\
+			return false;\
+		memmove(&vec->data[index + 1], &vec->data[index], (vec->len - index) * sizeof(T));\
+		vec->data[index] = value;\
+		vec->len++;\
+		return true;\
+	}\
+	static inline bool sv##T##_##N##_replace(sv##T##_##N *vec, size_t index, T value) {\
+		if (index >= vec->len)\
+			return false;\
+		vec->data[index] = value;\
+		return true;\
+	}\
+	static inline bool sv##T##_##N##_replace_range(sv##T##_##N *vec, size_t index, const T *arr, size_t len, size_t range) {\
+		if (index >= vec->len || range > vec->len - index || len > (N) - (vec->len - range))\
+			return false;\
+		memmove(&vec->data[index + len], &vec->data[index + range], (vec->len - index - range) * sizeof(T));\
+		memcpy(&vec->data[index], arr, len * sizeof(T));\
+		vec->len = vec->len - range + len;\
+		return true;\
+	}\
+	static inline void sv##T##_##N##_clear(sv##T##_##N *vec) {\
+		vec->len = 0;\
+	}\
+	static inline cvec_t *sv##T##_##N##_to_cvec(const sv##T##_##N *vec) {\
+		cvec_t *heap = cvec_new(sizeof(T));\
+		if (heap && vec->len)\
+			cvec_append(heap, (void*)vec->data, vec->len, sizeof(T));\
+		return heap;\
+	}
+
+#define CVEC_MAP_TYPEDEF(K, V)\
+	typedef struct m##K##_##V m##K##_##V;\
+	static inline m##K##_##V *m##K##_##V##_new(cvec_map_hash_fn hash, cvec_map_eq_fn eq) {\
+		return (m##K##_##V*)cvec_map_new(sizeof(K), sizeof(V), hash, eq);\
+	}\
+	static inline size_t m##K##_##V##_len(const m##K##_##V *map) {\
+		return cvec_map_len((cvec_map_t*)map);\
+	}\
+	static inline size_t m##K##_##V##_capacity(const m##K##_##V *map) {\
+		return cvec_map_capacity((cvec_map_t*)map);\
+	}\
+	static inline void m##K##_##V##_del(m##K##_##V *map) {\
+		cvec_map_del((cvec_map_t*)map);\
+	}\
+	static inline void m##K##_##V##_reserve(m##K##_##V *map, size_t len) {\
+		cvec_map_reserve((cvec_map_t*)map, len);\
+	}\
+	static inline void m##K##_##V##_rehash(m##K##_##V *map, size_t capacity) {\
+		cvec_map_rehash((cvec_map_t*)map, capacity);\
+	}\
+	static inline bool m##K##_##V##_insert(m##K##_##V *map, K key, V value) {\
+		return cvec_map_insert((cvec_map_t*)map, &key, &value, sizeof(K), sizeof(V));\
+	}\
+	static inline bool m##K##_##V##_contains(const m##K##_##V *map, K key) {\
+		return cvec_map_contains((cvec_map_t*)map, &key);\
+	}\
+	static inline const V *m##K##_##V##_view(const m##K##_##V *map, K key) {\
+		return (const V*)cvec_map_view((cvec_map_t*)map, &key);\
+	}\
+	static inline V *m##K##_##V##_ptr(m##K##_##V *map, K key) {\
+		return (V*)cvec_map_ptr((cvec_map_t*)map, &key);\
+	}\
+	static inline bool m##K##_##V##_remove(m##K##_##V *map, K key) {\
+		return cvec_map_remove((cvec_map_t*)map, &key);\
+	}\
+	static inline void m##K##_##V##_clear(m##K##_##V *map) {\
+		cvec_map_clear((cvec_map_t*)map);\
+	}
+
+#define CVEC_SET_TYPEDEF(T)\
+	typedef struct s##T s##T;\
+	static inline s##T *s##T##_new(cvec_map_hash_fn hash, cvec_map_eq_fn eq) {\
+		return (s##T*)cvec_map_new(sizeof(T), 0, hash, eq);\
+	}\
+	static inline size_t s##T##_len(const s##T *set) {\
+		return cvec_map_len((cvec_map_t*)set);\
+	}\
+	static inline size_t s##T##_capacity(const s##T *set) {\
+		return cvec_map_capacity((cvec_map_t*)set);\
+	}\
+	static inline void s##T##_del(s##T *set) {\
+		cvec_map_del((cvec_map_t*)set);\
+	}\
+	static inline void s##T##_reserve(s##T *set, size_t len) {\
+		cvec_map_reserve((cvec_map_t*)set, len);\
+	}\
+	static inline void s##T##_rehash(s##T *set, size_t capacity) {\
+		cvec_map_rehash((cvec_map_t*)set, capacity);\
+	}\
+	static inline bool s##T##_insert(s##T *set, T key) {\
+		return cvec_map_insert((cvec_map_t*)set, &key, NULL, sizeof(T), 0);\
+	}\
+	static inline bool s##T##_contains(const s##T *set, T key) {\
+		return cvec_map_contains((cvec_map_t*)set, &key);\
+	}\
+	static inline bool s##T##_remove(s##T *set, T key) {\
+		return cvec_map_remove((cvec_map_t*)set, &key);\
+	}\
+	static inline void s##T##_clear(s##T *set) {\
+		cvec_map_clear((cvec_map_t*)set);\
 	}
 
 #ifdef __cplusplus
@@ -0,0 +1,384 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file include/cvec.hpp
+ * \brief Public C++ header file for the cvec library.
+ * \details This file contains cvec::vector, an owning wrapper around the 
+ * vector handle of the C library. The wrapper holds nothing but the handle,
+ * so it can be handed to C code with get() and created from C handles. */
+
+#ifndef CVEC_HPP
+#define CVEC_HPP
+
+#include "cvec.h"
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
+namespace cvec {
+
+/** Owning handle for a vector of T.
+ * \details The items are stored by the C library with memcpy, so T has to
+ * be trivially copyable. Copies are deep (cvec_clone), moves steal the 
+ * handle. Pointers and iterators are invalidated by every modifying 
+ * function, just like the pointers returned by the C library. */
+template <typename T>
+class vector {
+	static_assert(std::is_trivially_copyable<T>::value,
+		"cvec::vector requires a trivially copyable type.");
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using pointer = T*;
+	using const_pointer = const T*;
+	using iterator = T*;
+	using const_iterator = const T*;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	/** Creates an empty vector. */
+	vector() : m_vec(cvec_new(sizeof(T))) {
+		if (!m_vec)
+			throw std::bad_alloc();
+	}
+
+	/** Creates a vector holding the items of a list. */
+	vector(std::initializer_list<T> list) : vector() {
+		append(list.begin(), list.size());
+	}
+
+	/** Takes ownership of a handle created by the C library.
+	 * \param vec A handle to a vector of T (or NULL). */
+	explicit vector(cvec_t *vec) : m_vec(vec) {
+		if (vec && cvec_size(vec) != sizeof(T))
+			throw std::invalid_argument("cvec::vector: item size mismatch.");
+	}
+
+	/** Creates a deep copy of another vector. */
+	vector(const vector &other) : m_vec(nullptr) {
+		if (other.m_vec && !(m_vec = cvec_clone(other.m_vec)))
+			throw std::bad_alloc();
+	}
+
+	/** Steals the handle of another vector, leaving it empty-handed. */
+	vector(vector &&other) noexcept : m_vec(other.m_vec) {
+		other.m_vec = nullptr;
+	}
+
+	/** Replaces the contents with a deep copy of another vector. */
+	vector &operator=(const vector &other) {
+		if (this != &other)
+			vector(other).swap(*this);
+		return *this;
+	}
+
+	/** Replaces the handle with the handle of another vector. */
+	vector &operator=(vector &&other) noexcept {
+		if (this != &other) {
+			reset();
+			m_vec = other.m_vec;
+			other.m_vec = nullptr;
+		}
+		return *this;
+	}
+
+	/** Deletes the owned handle. */
+	~vector() {
+		reset();
+	}
+
+	/** Returns the owned handle without giving up ownership. */
+	cvec_t *get() const noexcept {
+		return m_vec;
+	}
+
+	/** Gives up ownership of the handle and returns it. */
+	cvec_t *release() noexcept {
+		cvec_t *vec = m_vec;
+		m_vec = nullptr;
+		return vec;
+	}
+
+	/** Deletes the owned handle and takes ownership of another one. */
+	void reset(cvec_t *vec = nullptr) noexcept {
+		if (m_vec)
+			cvec_del(m_vec);
+		m_vec = vec;
+	}
+
+	/** Swaps the handles of two vectors. */
+	void swap(vector &other) noexcept {
+		std::swap(m_vec, other.m_vec);
+	}
+
+	/** Creates a copy-on-write snapshot (see cvec_snapshot). Other threads
+	 * may read it, but it must be destroyed on the creating thread. */
+	vector snapshot() {
+		cvec_t *vec = cvec_snapshot(m_vec);
+		if (!vec)
+			throw std::bad_alloc();
+		return vector(vec);
+	}
+
+	size_type size() const noexcept {
+		return m_vec ? layout()->len : 0;
+	}
+
+	size_type capacity() const noexcept {
+		return m_vec ? cvec_capacity(m_vec) : 0;
+	}
+
+	bool empty() const noexcept {
+		return !size();
+	}
+
+	/** Returns the items for writing, first giving the vector a private 
+	 * copy of data it shares with snapshots. */
+	T *data() {
+		if (!m_vec)
+			return nullptr;
+		if (layout()->shared && !cvec_data_ptr(m_vec))
+			throw std::bad_alloc();
+		return static_cast<T*>(layout()->data);
+	}
+
+	const T *data() const noexcept {
+		return m_vec ? static_cast<const T*>(layout()->data) : nullptr;
+	}
+
+	T &operator[](size_type index) {
+		return data()[index];
+	}
+
+	const T &operator[](size_type index) const noexcept {
+		return data()[index];
+	}
+
+	T &at(size_type index) {
+		if (index >= size())
+			throw std::out_of_range("cvec::vector: index is out of bounds.");
+		return data()[index];
+	}
+
+	const T &at(size_type index) const {
+		if (index >= size())
+			throw std::out_of_range("cvec::vector: index is out of bounds.");
+		return data()[index];
+	}
+
+	T &front() { return data()[0]; }
+	const T &front() const noexcept { return data()[0]; }
+	T &back() { return data()[size() - 1]; }
+	const T &back() const noexcept { return data()[size() - 1]; }
+
+	iterator begin() { return data(); }
+	iterator end() { T *items = data(); return items + size(); }
+	const_iterator begin() const noexcept { return data(); }
+	const_iterator end() const noexcept { return data() + size(); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+	reverse_iterator rbegin() { return reverse_iterator(end()); }
+	reverse_iterator rend() { return reverse_iterator(begin()); }
+	const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+	const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+#ifdef __cpp_lib_span
+	operator std::span<T>() { return std::span<T>(data(), size()); }
+	operator std::span<const T>() const noexcept { return std::span<const T>(data(), size()); }
+#endif
+
+	void push_back(const T &value) {
+		size_type len = size();
+		T tmp = value;
+		cvec_push_back(handle(), &tmp, sizeof(T));
+		check_len(len + 1);
+	}
+
+	void push_front(const T &value) {
+		size_type len = size();
+		T tmp = value;
+		cvec_push_front(handle(), &tmp, sizeof(T));
+		check_len(len + 1);
+	}
+
+	void pop_back() {
+		cvec_pop_back(handle());
+	}
+
+	void pop_front() {
+		cvec_pop_front(handle());
+	}
+
+	void append(const T *arr, size_type len) {
+		if (aliases(arr)) {
+			vector copy;
+			copy.append(arr, len);
+			append(copy.data(), len);
+			return;
+		}
+		size_type old_len = size();
+		cvec_append(handle(), const_cast<T*>(arr), len, sizeof(T));
+		check_len(old_len + len);
+	}
+
+	void prepend(const T *arr, size_type len) {
+		if (aliases(arr)) {
+			vector copy;
+			copy.append(arr, len);
+			prepend(copy.data(), len);
+			return;
+		}
+		size_type old_len = size();
+		cvec_prepend(handle(), const_cast<T*>(arr), len, sizeof(T));
+		check_len(old_len + len);
+	}
+
+	void insert(size_type index, const T &value) {
+		size_type len = size();
+		if (index >= len)
+			throw std::out_of_range("cvec::vector: index is out of bounds.");
+		T tmp = value;
+		cvec_insert(handle(), index, &tmp, sizeof(T));
+		check_len(len + 1);
+	}
+
+	void remove(size_type index) {
+		cvec_remove(handle(), index);
+	}
+
+	void replace_range(size_type index, const T *arr, size_type len, size_type range) {
+		if (aliases(arr)) {
+			vector copy;
+			copy.append(arr, len);
+			replace_range(index, copy.data(), len, range);
+			return;
+		}
+		cvec_replace_range(handle(), index, const_cast<T*>(arr), len, range, sizeof(T));
+	}
+
+	void resize(size_type len, const T &value = T()) {
+		T tmp = value;
+		cvec_resize(handle(), len, &tmp, sizeof(T));
+		check_len(len);
+	}
+
+	void assign(size_type len, const T &value) {
+		T tmp = value;
+		cvec_assign(handle(), len, &tmp, sizeof(T));
+		check_len(len);
+	}
+
+	void fill_range(size_type index, size_type len, const T &value) {
+		if (index > size() || len > size() - index)
+			throw std::out_of_range("cvec::vector: range is out of bounds.");
+		T tmp = value;
+		cvec_fill_range(handle(), index, len, &tmp, sizeof(T));
+	}
+
+	void clear() {
+		resize(0);
+	}
+
+	void gather(const vector &src, const size_type *idx, size_type len) {
+		if (this == &src)
+			throw std::invalid_argument("cvec::vector: cannot gather from itself.");
+		for (size_type i = 0; i < len; i++)
+			if (idx[i] >= src.size())
+				throw std::out_of_range("cvec::vector: index is out of bounds.");
+		cvec_gather(handle(), const_cast<vector&>(src).handle(), idx, len);
+		check_len(len);
+	}
+
+	void scatter(const vector &src, const size_type *idx) {
+		if (this == &src)
+			throw std::invalid_argument("cvec::vector: cannot scatter into itself.");
+		for (size_type i = 0; i < src.size(); i++)
+			if (idx[i] >= size())
+				throw std::out_of_range("cvec::vector: index is out of bounds.");
+		cvec_scatter(handle(), const_cast<vector&>(src).handle(), idx);
+	}
+
+	void permute(const size_type *perm) {
+		size_type len = size();
+		for (size_type i = 0; i < len; i++)
+			if (perm[i] >= len)
+				throw std::out_of_range("cvec::vector: index is out of bounds.");
+		cvec_permute(handle(), perm);
+		check_len(len);
+	}
+
+private:
+	/** Returns the first member of the handle for inline reads. */
+	const cvec_layout *layout() const noexcept {
+		return reinterpret_cast<const cvec_layout*>(m_vec);
+	}
+
+	/** Returns whether arr points into the items of this vector, which the
+	 * C library may move before reading them. */
+	bool aliases(const T *arr) const noexcept {
+		const T *items = data();
+		return items && std::less_equal<const T*>()(items, arr) &&
+			std::less<const T*>()(arr, items + size());
+	}
+
+	/** Returns the handle, recreating it if this vector was moved from. */
+	cvec_t *handle() {
+		if (!m_vec && !(m_vec = cvec_new(sizeof(T))))
+			throw std::bad_alloc();
+		return m_vec;
+	}
+
+	/** Turns a failed growth of the C library into an exception. */
+	void check_len(size_type len) const {
+		if (size() != len)
+			throw std::bad_alloc();
+	}
+
+	/** The owned handle. */
+	cvec_t *m_vec;
+};
+
+static_assert(sizeof(vector<int>) == sizeof(cvec_t*),
+	"cvec::vector must stay layout compatible with a cvec_t pointer.");
+
+template <typename T>
+void swap(vector<T> &a, vector<T> &b) noexcept {
+	a.swap(b);
+}
+
+} /* namespace cvec */
+
+#endif
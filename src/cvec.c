@@ -24,33 +24,330 @@ SOFTWARE.
 
 /** \file src/cvec.c
  * \brief Implementation for the cvec library.
- * \details This file contains the definition of the vector object and 
- * the implementations of the public functions for the cvec library. */
+ * \details This file contains the implementations of the public vector
+ * functions for the cvec library. */
 
-#include "cvec.h"
+#include "cvec_private.h"
 #include <carena.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
-_Thread_local static const char *g_err;
+/** The size of the pattern that is copied repeatedly once a fill has 
+ * built it by doubling. It is small enough to stay in cache. */
+#define FILL_CHUNK ((size_t)16 << 10)
 
-/** The default capacity of the vector object. */
-#define DEFAULT_CAPACITY 8
+/** The size of a transparent huge page. */
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
 
-/** Opaque handle for the vector object. */
-struct cvec {
-	/** Pointer to the vector data. */
+CVEC_HIDDEN _Thread_local const char *cvec_g_err;
+
+/** Rounds an address up to a multiple of a power of two alignment. */
+static inline uintptr_t align_up(uintptr_t addr, size_t alignment) {
+	return (addr + alignment - 1) & ~(uintptr_t)(alignment - 1);
+}
+
+/** Returns the number of extra bytes allocated so that the data of a vector
+ * can be aligned inside its block. */
+static inline size_t data_padding(const cvec_t *vec) {
+	return vec->alignment > 1 ? vec->alignment - 1 : 0;
+}
+
+/** Returns a pointer to the first properly aligned byte of a block. */
+static inline void *data_in_block(const cvec_t *vec, void *block) {
+	if (vec->alignment <= 1)
+		return block;
+	return (void*)align_up((uintptr_t)block, vec->alignment);
+}
+
+/** Allocates a block for a number of items honouring the alignment of 
+ * a vector.
+ * \param block Receives the pointer to the block.
+ * \param block_size Receives the allocated size of the block.
+ * \return A pointer to the aligned data or NULL on failure. */
+static void *alloc_data(
+	const cvec_t *vec, size_t capacity, void **block, size_t *block_size)
+{
+	*block_size = capacity * vec->sizeof_type + data_padding(vec);
+	*block = cvec_cache_alloc(block_size);
+	if (!*block)
+		return NULL;
+	return data_in_block(vec, *block);
+}
+
+/** Allocates a vector header. While the cache is enabled the header is 
+ * rounded up to a size class so that it can be recycled, otherwise it 
+ * takes only the size of the struct. */
+static cvec_t *alloc_header() {
+	size_t size = sizeof(cvec_t);
+	cvec_t *vec = cvec_cache_alloc(&size);
+	if (vec)
+		vec->header_in_class = size != sizeof(cvec_t);
+	return vec;
+}
+
+/** Frees a vector header. */
+static void free_header(cvec_t *vec) {
+	size_t size = sizeof(cvec_t);
+	if (vec->header_in_class) {
+		size_t class_size = 1;
+		while (class_size < size)
+			class_size *= 2;
+		size = class_size;
+	}
+	cvec_cache_free(vec, size);
+}
+
+/** Copies the contents of one vector header to another, keeping the 
+ * allocation details of the destination header. */
+static void copy_header(cvec_t *dst, const cvec_t *src) {
+	bool header_in_class = dst->header_in_class;
+	*dst = *src;
+	dst->header_in_class = header_in_class;
+}
+
+/** Swaps the contents of two vector headers, leaving each header's own
+ * allocation details in place.
+ * \param a A pointer to the first vector.
+ * \param b A pointer to the second vector. */
+void cvec_swap(cvec_t *a, cvec_t *b) {
+	struct cvec_vector old = *a;
+	copy_header(a, b);
+	copy_header(b, &old);
+}
+
+/** Asks the kernel to back the data of a vector with transparent huge 
+ * pages if the vector opted in and its data spans at least one of them. */
+static void advise_huge_pages(const cvec_t *vec) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	size_t size = vec->capacity * vec->sizeof_type;
+	if (!vec->huge_pages || size < HUGE_PAGE_SIZE)
+		return;
+	size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	uintptr_t begin = align_up((uintptr_t)vec->layout.data, page_size);
+	uintptr_t end = ((uintptr_t)vec->layout.data + size) & ~(uintptr_t)(page_size - 1);
+	if (end > begin)
+		(void)madvise((void*)begin, end - begin, MADV_HUGEPAGE);
+#else
+	(void)vec;
+#endif
+}
+
+/** Returns the capacity the doubling growth policy reaches for len items,
+ * or 0 if the size of such a block would overflow size_t. */
+static size_t grown_capacity(const cvec_t *vec, size_t len) {
+	size_t max_capacity = (SIZE_MAX - data_padding(vec)) / vec->sizeof_type;
+	size_t capacity = vec->capacity;
+	while (len > capacity) {
+		if (capacity > max_capacity / 2)
+			return 0;
+		capacity *= 2;
+	}
+	return capacity;
+}
+
+/** Returns the capacity the doubling growth policy reaches for count items
+ * on top of kept ones, or 0 if that would overflow size_t. */
+static size_t grown_capacity_by(const cvec_t *vec, size_t kept, size_t count) {
+	return count > SIZE_MAX - kept ? 0 : grown_capacity(vec, kept + count);
+}
+
+/** Returns the capacity the halving shrink policy settles on for len items. */
+static size_t shrunk_capacity(const cvec_t *vec, size_t len) {
+	if (len < vec->capacity / 2 && vec->capacity / 2 >= DEFAULT_CAPACITY)
+		return vec->capacity / 2;
+	return vec->capacity;
+}
+
+/** Returns the capacity a vector settles on when its length is set to len
+ * at once, applying the growth or the shrink policy as many times as 
+ * needed. */
+static size_t capacity_for(const cvec_t *vec, size_t len) {
+	if (len > vec->capacity)
+		return grown_capacity(vec, len);
+	size_t capacity = vec->capacity;
+	while (len < capacity / 2 && capacity / 2 >= DEFAULT_CAPACITY)
+		capacity /= 2;
+	return capacity;
+}
+
+/** Drops a vector's reference to its shared data and frees the data 
+ * if it was the last reference. */
+static void release_data(cvec_t *vec) {
+	if (atomic_fetch_sub(refcount_of(vec), 1) == 1) {
+		carena_free(vec->layout.shared);
+		cvec_cache_free(vec->block, vec->block_size);
+	}
+	vec->layout.shared = NULL;
+	vec->block = NULL;
+	vec->layout.data = NULL;
+}
+
+/** Resizes the data of a vector to a new capacity.
+ * \details If the data is shared with snapshots, the vector gets a private
+ * copy of it first, so this is also the copy-on-write step of every
+ * modifying function. A capacity of 0 stands for an overflowing size 
+ * and is rejected before the allocator is called.
+ * \return false on failure. */
+static bool resize_data(cvec_t *vec, size_t capacity) {
+	if (!capacity) {
+		cvec_g_err = "Vector is too large.";
+		return false;
+	}
+	if (refcount_of(vec)) {
+		if (atomic_load(refcount_of(vec)) == 1) {
+			carena_free(vec->layout.shared);
+			vec->layout.shared = NULL;
+		} else {
+			void *block;
+			size_t block_size;
+			void *data = alloc_data(vec, capacity, &block, &block_size);
+			if (!data) {
+				cvec_g_err = "Failed to copy shared vector data.";
+				return false;
+			}
+			memcpy(data, vec->layout.data, vec->layout.len * vec->sizeof_type);
+			release_data(vec);
+			vec->block = block;
+			vec->block_size = block_size;
+			vec->layout.data = data;
+			vec->capacity = capacity;
+			advise_huge_pages(vec);
+			return true;
+		}
+	}
+	if (capacity == vec->capacity)
+		return true;
+	size_t block_size = capacity * vec->sizeof_type + data_padding(vec);
+	void *block;
 	void *data;
+	if (cvec_cache_enabled()) {
+		/* Moving to a recycled block of the new size class keeps every
+		 * block the vector frees reusable. */
+		block = cvec_cache_alloc(&block_size);
+		if (!block) {
+			cvec_g_err = "Failed to resize vector.";
+			return false;
+		}
+		data = data_in_block(vec, block);
+		memcpy(data, vec->layout.data, vec->layout.len * vec->sizeof_type);
+		cvec_cache_free(vec->block, vec->block_size);
+	} else {
+		size_t offset = (size_t)((unsigned char*)vec->layout.data - (unsigned char*)vec->block);
+		block = carena_realloc(vec->block, block_size);
+		if (!block) {
+			cvec_g_err = "Failed to resize vector.";
+			return false;
+		}
+		/* The allocator only preserves its own alignment, so the items
+		 * are moved if the block landed at a differently aligned address. */
+		data = data_in_block(vec, block);
+		if (data != (unsigned char*)block + offset)
+			memmove(data, (unsigned char*)block + offset, vec->layout.len * vec->sizeof_type);
+	}
+	vec->block = block;
+	vec->block_size = block_size;
+	vec->layout.data = data;
+	vec->capacity = capacity;
+	advise_huge_pages(vec);
+	return true;
+}
 
-	/** The size of the vector's type. */
-	size_t sizeof_type;
+/** Makes sure a vector does not share its data with any snapshot.
+ * \param vec A pointer to the vector to be detached.
+ * \return false on failure. */
+bool cvec_detach(cvec_t *vec) {
+	return !refcount_of(vec) || resize_data(vec, vec->capacity);
+}
+
+/** Grows a vector to a given length following the doubling growth policy.
+ * The new items are zeroed.
+ * \param vec A pointer to the vector to be grown.
+ * \param len The new length (must not be less than the current one).
+ * \return false on failure. */
+bool cvec_grow_zeroed(cvec_t *vec, size_t len) {
+	if (!resize_data(vec, grown_capacity(vec, len)))
+		return false;
+	unsigned char *chardata = (unsigned char*)((vec->layout.data));
+	memset(&chardata[vec->layout.len * vec->sizeof_type], 0,
+		(len - vec->layout.len) * vec->sizeof_type);
+	vec->layout.len = len;
+	return true;
+}
 
-	/** The current capacity of the vector. */
-	size_t capacity;
+/** Replaces the data of a vector with an uninitialized block of a new 
+ * capacity.
+ * \details Unlike resize_data, nothing is copied: a new block is allocated
+ * and the old one is freed (or released if it is shared), so the pages of 
+ * a large buffer are first touched by whoever fills it. The data is kept
+ * in place if it is private and the capacity does not change. On failure
+ * the vector is left unchanged.
+ * \return false on failure. */
+static bool replace_data(cvec_t *vec, size_t capacity) {
+	if (!capacity) {
+		cvec_g_err = "Vector is too large.";
+		return false;
+	}
+	if (capacity == vec->capacity &&
+		(!refcount_of(vec) || atomic_load(refcount_of(vec)) == 1))
+		return resize_data(vec, capacity);
+	void *block;
+	size_t block_size;
+	void *data = alloc_data(vec, capacity, &block, &block_size);
+	if (!data) {
+		cvec_g_err = "Failed to resize vector.";
+		return false;
+	}
+	if (refcount_of(vec))
+		release_data(vec);
+	else
+		cvec_cache_free(vec->block, vec->block_size);
+	vec->block = block;
+	vec->block_size = block_size;
+	vec->layout.data = data;
+	vec->capacity = capacity;
+	advise_huge_pages(vec);
+	return true;
+}
 
-	/** The current length of the vector. */
-	size_t len;
-};
+/** Shrinks the capacity of a vector to its length (but not below the
+ * default capacity).
+ * \param vec A pointer to the vector to be shrunk.
+ * \return false on failure. */
+bool cvec_shrink_to_fit(cvec_t *vec) {
+	return resize_data(vec, vec->layout.len > DEFAULT_CAPACITY ? vec->layout.len : DEFAULT_CAPACITY);
+}
+
+/** Sets the length of a vector, reallocating it at most once. Items below
+ * both lengths are kept and new items are left uninitialized.
+ * \param vec A pointer to the vector to be modified.
+ * \param len The new length.
+ * \return false on failure. */
+bool cvec_set_len(cvec_t *vec, size_t len) {
+	if (len < vec->layout.len)
+		vec->layout.len = len;
+	if (!resize_data(vec, capacity_for(vec, len)))
+		return false;
+	vec->layout.len = len;
+	return true;
+}
+
+/** Sets the length of a vector, discarding all of its items. The items 
+ * are left uninitialized and are not copied by a reallocation.
+ * \param vec A pointer to the vector to be modified.
+ * \param len The new length.
+ * \return false on failure (the vector is left unchanged). */
+bool cvec_reset_len(cvec_t *vec, size_t len) {
+	if (!replace_data(vec, capacity_for(vec, len)))
+		return false;
+	vec->layout.len = len;
+	return true;
+}
 
 /** Returns the default capacity.
  * \return The default capacity. */
@@ -63,31 +360,121 @@ size_t cvec_default_capacity() {
  * in the vector.
  * \return A pointer to the allocated vector. */
 cvec_t *cvec_new(size_t sizeof_type) {
-	cvec_t *vec = carena_alloc(sizeof(cvec_t));
-	if (!vec) {
-		g_err = "Failed to allocate vector.";
+	return cvec_new_aligned(sizeof_type, 0);
+}
+
+/** Creates a new pointer for a specific type with aligned data.
+ * \param sizeof_type The size of the type that's meant to be stored 
+ * in the vector.
+ * \param alignment The alignment of the data (a power of two or 0 for
+ * the allocator's default). It is kept across every reallocation.
+ * \return A pointer to the allocated vector. */
+cvec_t *cvec_new_aligned(size_t sizeof_type, size_t alignment) {
+	if (alignment & (alignment - 1)) {
+		cvec_g_err = "Invalid argument.";
 		return NULL;
 	}
-	vec->data = carena_alloc(sizeof_type * DEFAULT_CAPACITY);
-	if (!vec->data) {
-		g_err = "Failed to allocate vector data.";
+	cvec_t *vec = alloc_header();
+	if (!vec) {
+		cvec_g_err = "Failed to allocate vector.";
 		return NULL;
 	}
 	vec->sizeof_type = sizeof_type;
+	vec->alignment = alignment;
+	vec->layout.data = alloc_data(vec, DEFAULT_CAPACITY, &vec->block, &vec->block_size);
+	if (!vec->layout.data) {
+		cvec_g_err = "Failed to allocate vector data.";
+		free_header(vec);
+		return NULL;
+	}
 	vec->capacity = DEFAULT_CAPACITY;
-	vec->len = 0;
+	vec->layout.len = 0;
+	vec->layout.shared = NULL;
+	vec->huge_pages = false;
 	return vec;
 }
 
+/** Opts a vector in or out of transparent huge pages.
+ * \details When enabled, every buffer of at least 2 MiB the vector 
+ * allocates is advised with madvise(MADV_HUGEPAGE). This is a hint that
+ * does nothing on systems without transparent huge pages.
+ * \param vec A pointer to the vector to be modified.
+ * \param enable Whether huge pages should be requested. */
+void cvec_set_huge_pages(cvec_t *vec, bool enable) {
+	if (!vec || !vec->layout.data) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	vec->huge_pages = enable;
+	advise_huge_pages(vec);
+}
+
+/** Creates a deep copy of a vector.
+ * \param vec A pointer to the vector to be copied.
+ * \return A pointer to the allocated copy. */
+cvec_t *cvec_clone(const cvec_t *vec) {
+	if (!vec || !vec->layout.data) {
+		cvec_g_err = "Invalid argument.";
+		return NULL;
+	}
+	cvec_t *clone = alloc_header();
+	if (!clone) {
+		cvec_g_err = "Failed to allocate vector.";
+		return NULL;
+	}
+	copy_header(clone, vec);
+	clone->layout.data = alloc_data(vec, vec->capacity, &clone->block, &clone->block_size);
+	if (!clone->layout.data) {
+		cvec_g_err = "Failed to allocate vector data.";
+		free_header(clone);
+		return NULL;
+	}
+	memcpy(clone->layout.data, vec->layout.data, vec->layout.len * vec->sizeof_type);
+	clone->layout.shared = NULL;
+	advise_huge_pages(clone);
+	return clone;
+}
+
+/** Creates a copy-on-write snapshot of a vector in O(1).
+ * \details The snapshot shares the data of the vector. Whichever of them 
+ * is modified first gets a private copy of the data. Both handles must be
+ * modified and deleted on the thread that created vec, because the 
+ * memory comes from the thread-local allocator.
+ * \param vec A pointer to the vector to be snapshotted.
+ * \return A pointer to the allocated snapshot. */
+cvec_t *cvec_snapshot(cvec_t *vec) {
+	if (!vec || !vec->layout.data) {
+		cvec_g_err = "Invalid argument.";
+		return NULL;
+	}
+	cvec_t *snapshot = alloc_header();
+	if (!snapshot) {
+		cvec_g_err = "Failed to allocate vector.";
+		return NULL;
+	}
+	if (!refcount_of(vec)) {
+		vec->layout.shared = carena_alloc(sizeof(_Atomic size_t));
+		if (!refcount_of(vec)) {
+			cvec_g_err = "Failed to allocate reference count.";
+			free_header(snapshot);
+			return NULL;
+		}
+		atomic_init(refcount_of(vec), 1);
+	}
+	atomic_fetch_add(refcount_of(vec), 1);
+	copy_header(snapshot, vec);
+	return snapshot;
+}
+
 /** Returns the the length of a vector.
  * \param vec A pointer to the vector to be accessed. 
  * \return The length of the vector. */
 size_t cvec_len(const cvec_t *vec) {
 	if (!vec) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return (size_t)-1;
 	}
-	return vec->len;
+	return vec->layout.len;
 }
 
 /** Returns the the size of a vector's type.
@@ -95,7 +482,7 @@ size_t cvec_len(const cvec_t *vec) {
  * \return The size of the vector's type. */
 size_t cvec_size(const cvec_t *vec) {
 	if (!vec) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return (size_t)-1;
 	}
 	return vec->sizeof_type;
@@ -106,7 +493,7 @@ size_t cvec_size(const cvec_t *vec) {
  * \return The capacity of the vector. */
 size_t cvec_capacity(const cvec_t *vec) {
 	if (!vec) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return (size_t)-1;
 	}
 	return vec->capacity;
@@ -115,12 +502,15 @@ size_t cvec_capacity(const cvec_t *vec) {
 /** Deletes a vector instance.
  * \param vec A pointer to the vector to be deleted. */
 void cvec_del(cvec_t *vec) {
-	if (!vec || !vec->data) {
-		g_err = "Invalid argument.";
+	if (!vec || !vec->layout.data) {
+		cvec_g_err = "Invalid argument.";
 		return;
 	}
-	carena_free(vec->data);
-	carena_free(vec);
+	if (refcount_of(vec))
+		release_data(vec);
+	else
+		cvec_cache_free(vec->block, vec->block_size);
+	free_header(vec);
 }
 
 /** Returns a const pointer to a vector item.
@@ -129,14 +519,14 @@ void cvec_del(cvec_t *vec) {
  * \return A const pointer to the item. */
 const void *cvec_view(const cvec_t *vec, size_t index) {
 	if (!vec) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return NULL;
 	}
-	if (index >= vec->len) {
-		g_err = "Index is out of bounds.";
+	if (index >= vec->layout.len) {
+		cvec_g_err = "Index is out of bounds.";
 		return NULL;
 	}
-	return (void*)((unsigned char*)vec->data + index * vec->sizeof_type);
+	return (void*)((unsigned char*)vec->layout.data + index * vec->sizeof_type);
 }
 
 /** Returns a pointer to a vector item.
@@ -145,14 +535,44 @@ const void *cvec_view(const cvec_t *vec, size_t index) {
  * \return A pointer to the item. */
 void *cvec_ptr(cvec_t *vec, size_t index) {
 	if (!vec) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return NULL;
 	}
-	if (index >= vec->len) {
-		g_err = "Index is out of bounds.";
+	if (index >= vec->layout.len) {
+		cvec_g_err = "Index is out of bounds.";
 		return NULL;
 	}
-	return (void*)((unsigned char*)vec->data + index * vec->sizeof_type);
+	if (!cvec_detach(vec))
+		return NULL;
+	return (void*)((unsigned char*)vec->layout.data + index * vec->sizeof_type);
+}
+
+/** Returns a const pointer to the first item of a vector.
+ * \details Unlike cvec_view this also works on an empty vector. The 
+ * pointer is invalidated by any function that modifies the vector.
+ * \param vec A pointer to the vector to be accessed.
+ * \return A const pointer to the data. */
+const void *cvec_data_view(const cvec_t *vec) {
+	if (!vec) {
+		cvec_g_err = "Invalid argument.";
+		return NULL;
+	}
+	return vec->layout.data;
+}
+
+/** Returns a pointer to the first item of a vector.
+ * \details Unlike cvec_ptr this also works on an empty vector. The 
+ * pointer is invalidated by any function that modifies the vector.
+ * \param vec A pointer to the vector to be accessed.
+ * \return A pointer to the data. */
+void *cvec_data_ptr(cvec_t *vec) {
+	if (!vec) {
+		cvec_g_err = "Invalid argument.";
+		return NULL;
+	}
+	if (!cvec_detach(vec))
+		return NULL;
+	return vec->layout.data;
 }
 
 /** Append an item at the end of the vector.
@@ -162,47 +582,33 @@ void *cvec_ptr(cvec_t *vec, size_t index) {
  * (must be the same as the value's). */
 void cvec_push_back(cvec_t *vec, void *value, size_t sizeof_type) {
 	if (
-		!vec || !vec->data || !value ||
+		!vec || !vec->layout.data || !value ||
 		sizeof_type != vec->sizeof_type
 	) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return;
 	}
-	if (vec->len + 1 > vec->capacity) {
-		void *tmp = carena_realloc(vec->data, vec->capacity * 2);
-		if (!tmp) {
-			g_err = "Failed to resize vector.";
-			return;
-		}
-		vec->data = tmp;
-		vec->capacity *= 2;
-	}
-	unsigned char *chardata = (unsigned char*)((vec->data));
-	memcpy(&chardata[vec->len * sizeof_type], value, sizeof_type);
-	vec->len++;
+	if (!resize_data(vec, grown_capacity(vec, vec->layout.len + 1)))
+		return;
+	unsigned char *chardata = (unsigned char*)((vec->layout.data));
+	memcpy(&chardata[vec->layout.len * sizeof_type], value, sizeof_type);
+	vec->layout.len++;
 }	
 
 /** Removes the last item of a vector.
  * \param vec A pointer to the vector to be modified. */
 void cvec_pop_back(cvec_t *vec) {
-	if (!vec || !vec->data) {
-		g_err = "Invalid argument.";
+	if (!vec || !vec->layout.data) {
+		cvec_g_err = "Invalid argument.";
 		return;
 	}
-	if (!vec->len) {
-		g_err = "Cannot pop empty vector.";
+	if (!vec->layout.len) {
+		cvec_g_err = "Cannot pop empty vector.";
 		return;
 	}
-	if (vec->len - 1 < vec->capacity / 2 && vec->capacity / 2 >= DEFAULT_CAPACITY) {
-		void *tmp = carena_realloc(vec->data, vec->capacity / 2);
-		if (!tmp) {
-			g_err = "Failed to resize vector.";
-			return;
-		}
-		vec->data = tmp;
-		vec->capacity /= 2;
-	}
-	vec->len--;
+	if (!resize_data(vec, shrunk_capacity(vec, vec->layout.len - 1)))
+		return;
+	vec->layout.len--;
 }
 
 /** Prepends an item at the beginning of a vector.
@@ -212,50 +618,36 @@ void cvec_pop_back(cvec_t *vec) {
  * (must be the same as the value's). */
 void cvec_push_front(cvec_t *vec, void *value, size_t sizeof_type) {
 	if (
-		!vec || !vec->data || !value ||
+		!vec || !vec->layout.data || !value ||
 		sizeof_type != vec->sizeof_type
 	) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return;
 	}
-	if (vec->len + 1 > vec->capacity) {
-		void *tmp = carena_realloc(vec->data, vec->capacity * 2);
-		if (!tmp) {
-			g_err = "Failed to resize vector.";
-			return;
-		}
-		vec->data = tmp;
-		vec->capacity *= 2;
-	}
-	unsigned char *chardata = (unsigned char*)((vec->data));
-	memmove(&chardata[sizeof_type], chardata, sizeof_type * vec->len);
+	if (!resize_data(vec, grown_capacity(vec, vec->layout.len + 1)))
+		return;
+	unsigned char *chardata = (unsigned char*)((vec->layout.data));
+	memmove(&chardata[sizeof_type], chardata, sizeof_type * vec->layout.len);
 	memcpy(chardata, value, sizeof_type);
-	vec->len++;
+	vec->layout.len++;
 }
 
 /** Removes the first item of a vector.
  * \param vec A pointer to the vector to be modified. */
 void cvec_pop_front(cvec_t *vec) {
-	if (!vec || !vec->data) {
-		g_err = "Invalid argument.";
+	if (!vec || !vec->layout.data) {
+		cvec_g_err = "Invalid argument.";
 		return;
 	}
-	if (!vec->len) {
-		g_err = "Cannot pop empty vector.";
+	if (!vec->layout.len) {
+		cvec_g_err = "Cannot pop empty vector.";
 		return;
 	}
-	unsigned char *chardata = (unsigned char*)((vec->data));
-	memmove(chardata, &chardata[vec->sizeof_type], vec->sizeof_type * vec->len - 1);
-	if (vec->len - 1 < vec->capacity / 2 && vec->capacity / 2 >= DEFAULT_CAPACITY) {
-		void *tmp = carena_realloc(vec->data, vec->capacity / 2);
-		if (!tmp) {
-			g_err = "Failed to resize vector.";
-			return;
-		}
-		vec->data = tmp;
-		vec->capacity /= 2;
-	}
-	vec->len--;
+	if (!resize_data(vec, shrunk_capacity(vec, vec->layout.len - 1)))
+		return;
+	unsigned char *chardata = (unsigned char*)((vec->layout.data));
+	memmove(chardata, &chardata[vec->sizeof_type], vec->sizeof_type * (vec->layout.len - 1));
+	vec->layout.len--;
 }
 
 /** Appends an array at the end of a vector.
@@ -266,24 +658,17 @@ void cvec_pop_front(cvec_t *vec) {
  * (must be the same as the value's). */
 void cvec_append(cvec_t *vec, void *arr, size_t len, size_t sizeof_type) {
 	if (
-		!vec || !vec->data || !arr ||
+		!vec || !vec->layout.data || !arr ||
 		sizeof_type != vec->sizeof_type
 	) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return;
 	}
-	while (vec->len + len > vec->capacity) {
-		void *tmp = carena_realloc(vec->data, vec->capacity * 2);
-		if (!tmp) {
-			g_err = "Failed to resize vector.";
-			return;
-		}
-		vec->data = tmp;
-		vec->capacity *= 2;
-	}
-	unsigned char *chardata = (unsigned char*)((vec->data));
-	memcpy(&chardata[vec->len * sizeof_type], arr, len * sizeof_type);
-	vec->len += len;
+	if (!resize_data(vec, grown_capacity_by(vec, vec->layout.len, len)))
+		return;
+	unsigned char *chardata = (unsigned char*)((vec->layout.data));
+	memcpy(&chardata[vec->layout.len * sizeof_type], arr, len * sizeof_type);
+	vec->layout.len += len;
 }
 
 /** Prepends an array at the beginning of a vector.
@@ -294,59 +679,45 @@ void cvec_append(cvec_t *vec, void *arr, size_t len, size_t sizeof_type) {
  * (must be the same as the value's). */
 void cvec_prepend(cvec_t *vec, void *arr, size_t len, size_t sizeof_type) {
 	if (
-		!vec || !vec->data || !arr ||
+		!vec || !vec->layout.data || !arr ||
 		sizeof_type != vec->sizeof_type
 	) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return;
 	}
-	while (vec->len + len > vec->capacity) {
-		void *tmp = carena_realloc(vec->data, vec->capacity * 2);
-		if (!tmp) {
-			g_err = "Failed to resize vector.";
-			return;
-		}
-		vec->data = tmp;
-		vec->capacity *= 2;
-	}
-	unsigned char *chardata = (unsigned char*)((vec->data));
-	memmove(&chardata[len * sizeof_type], chardata, vec->len * sizeof_type);
+	if (!resize_data(vec, grown_capacity_by(vec, vec->layout.len, len)))
+		return;
+	unsigned char *chardata = (unsigned char*)((vec->layout.data));
+	memmove(&chardata[len * sizeof_type], chardata, vec->layout.len * sizeof_type);
 	memcpy(chardata, arr, len * sizeof_type);
-	vec->len += len;
+	vec->layout.len += len;
 }
 
 /** Removes an item of a vector.
  * \param vec A pointer to the vector to be modified.
  * \param index The item's index. */
 void cvec_remove(cvec_t *vec, size_t index) {
-	if (!vec || !vec->data) {
-		g_err = "Invalid argument.";
+	if (!vec || !vec->layout.data) {
+		cvec_g_err = "Invalid argument.";
 		return;
 	}
-	if (!vec->len) {
-		g_err = "Cannot remove from empty vector.";
+	if (!vec->layout.len) {
+		cvec_g_err = "Cannot remove from empty vector.";
 		return;
 	}
-	if (index >= vec->len) {
-		g_err = "index is out of bounds.";
+	if (index >= vec->layout.len) {
+		cvec_g_err = "index is out of bounds.";
 		return;
 	}
-	unsigned char *chardata = (unsigned char*)((vec->data));
-	size_t len_to_move = vec->len - index + 1;
+	if (!resize_data(vec, shrunk_capacity(vec, vec->layout.len - 1)))
+		return;
+	unsigned char *chardata = (unsigned char*)((vec->layout.data));
+	size_t len_to_move = vec->layout.len - index - 1;
 	memmove(
 		&chardata[index * vec->sizeof_type],
 		&chardata[(index + 1) * vec->sizeof_type],
 		len_to_move * vec->sizeof_type);
-	if (vec->len - 1 < vec->capacity / 2 && vec->capacity / 2 >= DEFAULT_CAPACITY) {
-		void *tmp = carena_realloc(vec->data, vec->capacity / 2);
-		if (!tmp) {
-			g_err = "Failed to resize vector.";
-			return;
-		}
-		vec->data = tmp;
-		vec->capacity /= 2;
-	}
-	vec->len--;
+	vec->layout.len--;
 }
 
 /** Inserts an item into a vector.
@@ -357,33 +728,26 @@ void cvec_remove(cvec_t *vec, size_t index) {
  * (must be the same as the value's). */
 void cvec_insert(cvec_t *vec, size_t index, void *value, size_t sizeof_type) {
 	if (
-		!vec || !vec->data || !value ||
+		!vec || !vec->layout.data || !value ||
 		sizeof_type != vec->sizeof_type
 	) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return;
 	}
-	if (index >= vec->len) {
-		g_err = "index is out of bounds.";
+	if (index >= vec->layout.len) {
+		cvec_g_err = "index is out of bounds.";
 		return;
 	}
-	unsigned char *chardata = (unsigned char*)((vec->data));
-	size_t len_to_move = vec->len - index + 1;
+	if (!resize_data(vec, grown_capacity(vec, vec->layout.len + 1)))
+		return;
+	unsigned char *chardata = (unsigned char*)((vec->layout.data));
+	size_t len_to_move = vec->layout.len - index;
 	memmove(
 		&chardata[(index + 1) * sizeof_type],
 		&chardata[index * sizeof_type],
 		len_to_move * sizeof_type);
 	memcpy(&chardata[index * sizeof_type], value, sizeof_type);
-	if (vec->len + 1 > vec->capacity) {
-		void *tmp = carena_realloc(vec->data, vec->capacity * 2);
-		if (!tmp) {
-			g_err = "Failed to resize vector.";
-			return;
-		}
-		vec->data = tmp;
-		vec->capacity *= 2;
-	}
-	vec->len++;
+	vec->layout.len++;
 }
 
 /** Replaces an item in a vector.
@@ -394,17 +758,19 @@ void cvec_insert(cvec_t *vec, size_t index, void *value, size_t sizeof_type) {
  * (must be the same as the value's). */
 void cvec_replace(cvec_t *vec, size_t index, void *value, size_t sizeof_type) {
 	if (
-		!vec || !vec->data || !value ||
+		!vec || !vec->layout.data || !value ||
 		sizeof_type != vec->sizeof_type
 	) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return;
 	}
-	if (index >= vec->len) {
-		g_err = "index is out of bounds.";
+	if (index >= vec->layout.len) {
+		cvec_g_err = "index is out of bounds.";
 		return;
 	}
-	unsigned char *chardata = (unsigned char*)((vec->data));
+	if (!cvec_detach(vec))
+		return;
+	unsigned char *chardata = (unsigned char*)((vec->layout.data));
 	memcpy(&chardata[index * sizeof_type], value, sizeof_type);
 }
 
@@ -421,41 +787,162 @@ void cvec_replace_range(
 	size_t len, size_t range, size_t sizeof_type)
 {
 	if (
-		!vec || !vec->data || !arr ||
+		!vec || !vec->layout.data || !arr ||
 		sizeof_type != vec->sizeof_type
 	) {
-		g_err = "Invalid argument.";
+		cvec_g_err = "Invalid argument.";
 		return;
 	}
-	if (index >= vec->len) {
-		g_err = "index is out of bounds.";
+	if (index >= vec->layout.len) {
+		cvec_g_err = "index is out of bounds.";
 		return;
 	}
-	if (index + range > vec->len) {
-		g_err = "range is too big.";
+	if (index + range > vec->layout.len) {
+		cvec_g_err = "range is too big.";
 		return;
 	}
-	while (vec->len - range + len > vec->capacity) {
-		void *tmp = carena_realloc(vec->data, vec->capacity * 2);
-		if (!tmp) {
-			g_err = "Failed to resize vector.";
-			return;
-		}
-		vec->data = tmp;
-		vec->capacity *= 2;
-	}
-	unsigned char *chardata = (unsigned char*)((vec->data));
+	if (!resize_data(vec, grown_capacity_by(vec, vec->layout.len - range, len)))
+		return;
+	unsigned char *chardata = (unsigned char*)((vec->layout.data));
 	size_t move_by = len - range;
 	memmove(
 		&chardata[(index + range + move_by) * sizeof_type],
 		&chardata[(index + range) * sizeof_type],
-		(vec->len - index - range) * sizeof_type);
+		(vec->layout.len - index - range) * sizeof_type);
 	memcpy(&chardata[index * sizeof_type], arr, len * sizeof_type);
-	vec->len = vec->len - range + len;
+	vec->layout.len = vec->layout.len - range + len;
+}
+
+/** Fills count items with copies of value (or zeroes if value is NULL).
+ * \details A value whose bytes are all the same is a memset. Any other 
+ * value is written once and then copied in doubling runs up to FILL_CHUNK,
+ * after which that chunk is copied repeatedly. */
+static void fill_items(
+	unsigned char *dst, const unsigned char *value,
+	size_t sizeof_type, size_t count)
+{
+	if (!count)
+		return;
+	bool uniform = true;
+	for (size_t i = 1; value && i < sizeof_type && uniform; i++)
+		uniform = value[i] == value[0];
+	if (uniform) {
+		memset(dst, value ? value[0] : 0, count * sizeof_type);
+		return;
+	}
+	size_t total = count * sizeof_type;
+	size_t max_run = FILL_CHUNK > sizeof_type ?
+		FILL_CHUNK / sizeof_type * sizeof_type : sizeof_type;
+	memcpy(dst, value, sizeof_type);
+	for (size_t done = sizeof_type; done < total;) {
+		size_t run = done < max_run ? done : max_run;
+		run = run < total - done ? run : total - done;
+		memcpy(&dst[done], dst, run);
+		done += run;
+	}
+}
+
+/** Context of a parallel fill. */
+struct fill_ctx {
+	/** The first item to be filled. */
+	unsigned char *dst;
+
+	/** The value to fill with or NULL for zeroes. */
+	const unsigned char *value;
+
+	/** The size of the vector's type. */
+	size_t sizeof_type;
+};
+
+/** Fills the items [begin, end) of a parallel fill. */
+static void fill_chunk(void *ctx, size_t begin, size_t end) {
+	struct fill_ctx *fill = ctx;
+	fill_items(
+		&fill->dst[begin * fill->sizeof_type], fill->value,
+		fill->sizeof_type, end - begin);
+}
+
+/** Fills the items [index, index + count) of a vector, splitting the work
+ * over several threads for large ranges. */
+static void fill(cvec_t *vec, size_t index, const void *value, size_t count) {
+	unsigned char *chardata = (unsigned char*)((vec->layout.data));
+	struct fill_ctx ctx = {
+		.dst = &chardata[index * vec->sizeof_type],
+		.value = value,
+		.sizeof_type = vec->sizeof_type,
+	};
+	if (count * vec->sizeof_type < CVEC_PARALLEL_THRESHOLD) {
+		fill_chunk(&ctx, 0, count);
+		return;
+	}
+	cvec_parallel_for(
+		count, CVEC_PARALLEL_THRESHOLD / CVEC_MAX_THREADS / vec->sizeof_type,
+		fill_chunk, &ctx);
+}
+
+/** Sets the length of a vector, filling new items with a value.
+ * \details The vector is reallocated at most once. Buffers above 
+ * CVEC_PARALLEL_THRESHOLD bytes are filled by several threads, each 
+ * touching its own part of the buffer first.
+ * \param vec A pointer to the vector to be modified.
+ * \param len The new length.
+ * \param fill_value A pointer to the value of the new items 
+ * (NULL for zeroes).
+ * \param sizeof_type The size of the vector's type 
+ * (must be the same as the value's). */
+void cvec_resize(cvec_t *vec, size_t len, void *fill_value, size_t sizeof_type) {
+	if (!vec || !vec->layout.data || sizeof_type != vec->sizeof_type) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	size_t old_len = vec->layout.len;
+	if (!cvec_set_len(vec, len))
+		return;
+	if (len > old_len)
+		fill(vec, old_len, fill_value, len - old_len);
+}
+
+/** Replaces the contents of a vector with copies of a value.
+ * \param vec A pointer to the vector to be modified.
+ * \param len The new length.
+ * \param value A pointer to the value of the items (NULL for zeroes).
+ * \param sizeof_type The size of the vector's type 
+ * (must be the same as the value's). */
+void cvec_assign(cvec_t *vec, size_t len, void *value, size_t sizeof_type) {
+	if (!vec || !vec->layout.data || sizeof_type != vec->sizeof_type) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	if (!cvec_reset_len(vec, len))
+		return;
+	fill(vec, 0, value, len);
+}
+
+/** Overwrites a range of items of a vector with copies of a value.
+ * \param vec A pointer to the vector to be modified.
+ * \param index The index of the first item to be overwritten.
+ * \param len The number of items to be overwritten.
+ * \param value A pointer to the value of the items (NULL for zeroes).
+ * \param sizeof_type The size of the vector's type 
+ * (must be the same as the value's). */
+void cvec_fill_range(
+	cvec_t *vec, size_t index, size_t len, void *value, size_t sizeof_type)
+{
+	if (!vec || !vec->layout.data || sizeof_type != vec->sizeof_type) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	if (index > vec->layout.len || len > vec->layout.len - index) {
+		cvec_g_err = "range is too big.";
+		return;
+	}
+	if (!cvec_detach(vec))
+		return;
+	fill(vec, index, value, len);
 }
 
 /** Returns a string containing the latest error information if exists or 
  * NULL if it does not. */
 const char *cvec_get_error() {
-	return g_err;
+	return cvec_g_err;
 }
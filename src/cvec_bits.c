@@ -0,0 +1,371 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/cvec_bits.c
+ * \brief Implementation for the cvec bit vector.
+ * \details This file contains the definition of the bit vector object and 
+ * the implementations of its public functions. The bits are packed into a
+ * regular vector of 64 bit words, so the bit vector shares the growth
+ * policy and the allocator of the vector. Bits past the length of the bit
+ * vector are always kept zero, which lets the word-at-a-time functions
+ * ignore the partial last word. */
+
+#include "cvec_private.h"
+#include <carena.h>
+#include <string.h>
+#include <stdint.h>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+/** The number of bits in a word. */
+#define WORD_BITS 64
+
+/** Opaque handle for the bit vector object. */
+struct cvec_bits {
+	/** Vector of the 64 bit words holding the bits. */
+	cvec_t *words;
+
+	/** The number of bits. */
+	size_t len;
+};
+
+/** Returns a pointer to the words of a bit vector. */
+static inline uint64_t *words_of(const cvec_bits_t *bits) {
+	return (uint64_t*)bits->words->layout.data;
+}
+
+/** Returns the number of words needed to hold len bits. */
+static inline size_t words_for(size_t len) {
+	return (len + WORD_BITS - 1) / WORD_BITS;
+}
+
+/** Returns the number of set bits in an array of words. */
+static size_t popcount_words(const uint64_t *words, size_t len) {
+	/* Independent accumulators keep the popcnt units busy and let the
+	 * compiler vectorize the loop where a vector popcount exists. */
+	size_t count0 = 0, count1 = 0, count2 = 0, count3 = 0;
+	size_t i = 0;
+	for (; i + 4 <= len; i += 4) {
+		count0 += (size_t)__builtin_popcountll(words[i]);
+		count1 += (size_t)__builtin_popcountll(words[i + 1]);
+		count2 += (size_t)__builtin_popcountll(words[i + 2]);
+		count3 += (size_t)__builtin_popcountll(words[i + 3]);
+	}
+	for (; i < len; i++)
+		count0 += (size_t)__builtin_popcountll(words[i]);
+	return count0 + count1 + count2 + count3;
+}
+
+/** Returns the position of the nth (0-based) set bit of a word. */
+static inline size_t select_in_word(uint64_t word, size_t n) {
+#ifdef __BMI2__
+	return (size_t)__builtin_ctzll(_pdep_u64(1ull << n, word));
+#else
+	for (; n; n--)
+		word &= word - 1;
+	return (size_t)__builtin_ctzll(word);
+#endif
+}
+
+/** Creates a new, empty bit vector.
+ * \return A pointer to the allocated bit vector. */
+cvec_bits_t *cvec_bits_new() {
+	cvec_bits_t *bits = carena_alloc(sizeof(cvec_bits_t));
+	if (!bits) {
+		cvec_g_err = "Failed to allocate bit vector.";
+		return NULL;
+	}
+	bits->words = cvec_new(sizeof(uint64_t));
+	if (!bits->words) {
+		carena_free(bits);
+		return NULL;
+	}
+	bits->len = 0;
+	return bits;
+}
+
+/** Deletes a bit vector instance.
+ * \param bits A pointer to the bit vector to be deleted. */
+void cvec_bits_del(cvec_bits_t *bits) {
+	if (!bits || !bits->words) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	cvec_del(bits->words);
+	carena_free(bits);
+}
+
+/** Returns the number of bits in a bit vector.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \return The number of bits or (size_t)-1 on failure. */
+size_t cvec_bits_len(const cvec_bits_t *bits) {
+	if (!bits) {
+		cvec_g_err = "Invalid argument.";
+		return (size_t)-1;
+	}
+	return bits->len;
+}
+
+/** Appends a bit at the end of a bit vector.
+ * \param bits A pointer to the bit vector to be modified.
+ * \param value The value of the bit. */
+void cvec_bits_push_back(cvec_bits_t *bits, bool value) {
+	if (!bits || !bits->words) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	if (bits->len == bits->words->layout.len * WORD_BITS &&
+		!cvec_grow_zeroed(bits->words, bits->words->layout.len + 1))
+		return;
+	words_of(bits)[bits->len / WORD_BITS] |=
+		(uint64_t)value << (bits->len % WORD_BITS);
+	bits->len++;
+}
+
+/** Removes the last bit of a bit vector.
+ * \param bits A pointer to the bit vector to be modified. */
+void cvec_bits_pop_back(cvec_bits_t *bits) {
+	if (!bits || !bits->words) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	if (!bits->len) {
+		cvec_g_err = "Cannot pop empty vector.";
+		return;
+	}
+	bits->len--;
+	words_of(bits)[bits->len / WORD_BITS] &=
+		~((uint64_t)1 << (bits->len % WORD_BITS));
+	if (bits->len == (bits->words->layout.len - 1) * WORD_BITS)
+		cvec_pop_back(bits->words);
+}
+
+/** Returns the value of a bit.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \param index The index of the bit.
+ * \return The value of the bit (false on failure). */
+bool cvec_bits_get(const cvec_bits_t *bits, size_t index) {
+	if (!bits || !bits->words) {
+		cvec_g_err = "Invalid argument.";
+		return false;
+	}
+	if (index >= bits->len) {
+		cvec_g_err = "Index is out of bounds.";
+		return false;
+	}
+	return (words_of(bits)[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+/** Sets the value of a bit.
+ * \param bits A pointer to the bit vector to be modified.
+ * \param index The index of the bit.
+ * \param value The new value of the bit. */
+void cvec_bits_set(cvec_bits_t *bits, size_t index, bool value) {
+	if (!bits || !bits->words) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	if (index >= bits->len) {
+		cvec_g_err = "Index is out of bounds.";
+		return;
+	}
+	uint64_t mask = (uint64_t)1 << (index % WORD_BITS);
+	uint64_t *word = &words_of(bits)[index / WORD_BITS];
+	*word = value ? *word | mask : *word & ~mask;
+}
+
+/** Appends packed bits at the end of a bit vector.
+ * \param bits A pointer to the bit vector to be modified.
+ * \param words The bits to be appended, packed least significant bit first.
+ * \param len The number of bits to be appended. */
+void cvec_bits_append(cvec_bits_t *bits, const uint64_t *words, size_t len) {
+	if (!bits || !bits->words || (len && !words)) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	if (!cvec_grow_zeroed(bits->words, words_for(bits->len + len)))
+		return;
+	uint64_t *dst = &words_of(bits)[bits->len / WORD_BITS];
+	size_t shift = bits->len % WORD_BITS;
+	size_t count = words_for(len);
+	if (!shift) {
+		memcpy(dst, words, count * sizeof(uint64_t));
+	} else {
+		for (size_t i = 0; i < count; i++) {
+			dst[i] |= words[i] << shift;
+			if (i * WORD_BITS + WORD_BITS - shift < len)
+				dst[i + 1] = words[i] >> (WORD_BITS - shift);
+		}
+	}
+	bits->len += len;
+	if (bits->len % WORD_BITS)
+		words_of(bits)[bits->len / WORD_BITS] &=
+			((uint64_t)1 << (bits->len % WORD_BITS)) - 1;
+}
+
+/** Returns a pointer to the packed words of a bit vector.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \return A const pointer to the words, least significant bit first. */
+const uint64_t *cvec_bits_words(const cvec_bits_t *bits) {
+	if (!bits || !bits->words) {
+		cvec_g_err = "Invalid argument.";
+		return NULL;
+	}
+	return words_of(bits);
+}
+
+/** Returns the number of set bits in a bit vector.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \return The number of set bits or (size_t)-1 on failure. */
+size_t cvec_bits_popcount(const cvec_bits_t *bits) {
+	if (!bits || !bits->words) {
+		cvec_g_err = "Invalid argument.";
+		return (size_t)-1;
+	}
+	return popcount_words(words_of(bits), words_for(bits->len));
+}
+
+/** Returns the index of the first set bit at or after a given index.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \param index The index the search starts from.
+ * \return The index of the set bit or (size_t)-1 if there is none. */
+size_t cvec_bits_find_next_set(const cvec_bits_t *bits, size_t index) {
+	if (!bits || !bits->words) {
+		cvec_g_err = "Invalid argument.";
+		return (size_t)-1;
+	}
+	if (index >= bits->len)
+		return (size_t)-1;
+	const uint64_t *words = words_of(bits);
+	size_t i = index / WORD_BITS;
+	uint64_t word = words[i] & (~(uint64_t)0 << (index % WORD_BITS));
+	for (size_t count = words_for(bits->len); !word; word = words[i]) {
+		if (++i == count)
+			return (size_t)-1;
+	}
+	return i * WORD_BITS + (size_t)__builtin_ctzll(word);
+}
+
+/** Returns the index of the first set bit.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \return The index of the set bit or (size_t)-1 if there is none. */
+size_t cvec_bits_find_first_set(const cvec_bits_t *bits) {
+	return cvec_bits_find_next_set(bits, 0);
+}
+
+/** Returns the number of set bits before a given index.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \param index The index (may be equal to the length).
+ * \return The number of set bits or (size_t)-1 on failure. */
+size_t cvec_bits_rank(const cvec_bits_t *bits, size_t index) {
+	if (!bits || !bits->words || index > bits->len) {
+		cvec_g_err = "Invalid argument.";
+		return (size_t)-1;
+	}
+	const uint64_t *words = words_of(bits);
+	size_t rank = popcount_words(words, index / WORD_BITS);
+	if (index % WORD_BITS)
+		rank += (size_t)__builtin_popcountll(
+			words[index / WORD_BITS] &
+			(((uint64_t)1 << (index % WORD_BITS)) - 1));
+	return rank;
+}
+
+/** Returns the index of the nth (0-based) set bit.
+ * \param bits A pointer to the bit vector to be accessed.
+ * \param n The rank of the set bit.
+ * \return The index of the set bit or (size_t)-1 if there is none. */
+size_t cvec_bits_select(const cvec_bits_t *bits, size_t n) {
+	if (!bits || !bits->words) {
+		cvec_g_err = "Invalid argument.";
+		return (size_t)-1;
+	}
+	const uint64_t *words = words_of(bits);
+	size_t count = words_for(bits->len);
+	for (size_t i = 0; i < count; i++) {
+		size_t ones = (size_t)__builtin_popcountll(words[i]);
+		if (n < ones)
+			return i * WORD_BITS + select_in_word(words[i], n);
+		n -= ones;
+	}
+	return (size_t)-1;
+}
+
+/** Checks the arguments of the bulk operations. */
+static bool bulk_args_valid(const cvec_bits_t *dst, const cvec_bits_t *src) {
+	if (!dst || !dst->words || !src || !src->words || dst->len != src->len) {
+		cvec_g_err = "Invalid argument.";
+		return false;
+	}
+	return true;
+}
+
+/** Sets dst to the bitwise AND of dst and src.
+ * \param dst A pointer to the bit vector to be modified.
+ * \param src A pointer to a bit vector of the same length. */
+void cvec_bits_and(cvec_bits_t *dst, const cvec_bits_t *src) {
+	if (!bulk_args_valid(dst, src))
+		return;
+	uint64_t *d = words_of(dst);
+	const uint64_t *s = words_of(src);
+	for (size_t i = 0, count = words_for(dst->len); i < count; i++)
+		d[i] &= s[i];
+}
+
+/** Sets dst to the bitwise OR of dst and src.
+ * \param dst A pointer to the bit vector to be modified.
+ * \param src A pointer to a bit vector of the same length. */
+void cvec_bits_or(cvec_bits_t *dst, const cvec_bits_t *src) {
+	if (!bulk_args_valid(dst, src))
+		return;
+	uint64_t *d = words_of(dst);
+	const uint64_t *s = words_of(src);
+	for (size_t i = 0, count = words_for(dst->len); i < count; i++)
+		d[i] |= s[i];
+}
+
+/** Sets dst to the bitwise XOR of dst and src.
+ * \param dst A pointer to the bit vector to be modified.
+ * \param src A pointer to a bit vector of the same length. */
+void cvec_bits_xor(cvec_bits_t *dst, const cvec_bits_t *src) {
+	if (!bulk_args_valid(dst, src))
+		return;
+	uint64_t *d = words_of(dst);
+	const uint64_t *s = words_of(src);
+	for (size_t i = 0, count = words_for(dst->len); i < count; i++)
+		d[i] ^= s[i];
+}
+
+/** Clears the bits of dst that are set in src.
+ * \param dst A pointer to the bit vector to be modified.
+ * \param src A pointer to a bit vector of the same length. */
+void cvec_bits_andnot(cvec_bits_t *dst, const cvec_bits_t *src) {
+	if (!bulk_args_valid(dst, src))
+		return;
+	uint64_t *d = words_of(dst);
+	const uint64_t *s = words_of(src);
+	for (size_t i = 0, count = words_for(dst->len); i < count; i++)
+		d[i] &= ~s[i];
+}
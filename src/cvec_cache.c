@@ -0,0 +1,200 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/cvec_cache.c
+ * \brief Implementation for the cvec buffer cache.
+ * \details This file contains the per-thread cache that recycles the vector
+ * headers and data buffers freed by the library. Blocks are kept in 
+ * power of two size classes, each a singly linked list threaded through 
+ * the cached blocks themselves. The cache is disabled until limits are set
+ * for the calling thread, which also registers a destructor that frees 
+ * the thread's cached blocks when it exits. */
+
+#include "cvec_private.h"
+#include <carena.h>
+#include <pthread.h>
+
+/** Log2 of the smallest size class. */
+#define MIN_CLASS 4
+
+/** Log2 of the largest size class. */
+#define MAX_CLASS 30
+
+/** The number of size classes. */
+#define NUM_CLASSES (MAX_CLASS - MIN_CLASS + 1)
+
+/** A cached block. */
+struct cached {
+	/** The next block of the same size class. */
+	struct cached *next;
+};
+
+/** The cache of a thread. */
+struct cache {
+	/** Cached blocks per size class. */
+	struct cached *lists[NUM_CLASSES];
+
+	/** The number of cached blocks per size class. */
+	size_t counts[NUM_CLASSES];
+
+	/** The total size of the cached blocks. */
+	size_t bytes;
+
+	/** The maximum total size of the cached blocks (0 disables the cache). */
+	size_t max_bytes;
+
+	/** The maximum number of cached blocks per size class. */
+	size_t max_blocks;
+
+	/** Whether the thread exit destructor is registered for this cache. */
+	bool registered;
+};
+
+_Thread_local static struct cache g_cache;
+
+/** The key whose destructor trims the cache of an exiting thread. */
+static pthread_key_t g_key;
+
+/** Whether g_key was created. */
+static bool g_key_created;
+
+/** Guards the creation of g_key. */
+static pthread_once_t g_key_once = PTHREAD_ONCE_INIT;
+
+/** Returns log2 of the smallest size class that fits size. */
+static inline unsigned class_of(size_t size) {
+	unsigned c = MIN_CLASS;
+	while (c <= MAX_CLASS && ((size_t)1 << c) < size)
+		c++;
+	return c;
+}
+
+/** Returns whether the calling thread's cache is enabled. */
+bool cvec_cache_enabled() {
+	return g_cache.max_bytes != 0;
+}
+
+/** Allocates a block, reusing a cached one if possible.
+ * \param size The requested size. While the cache is enabled it is 
+ * rounded up to the size class and updated to the allocated size.
+ * \return A pointer to the block or NULL on failure. */
+void *cvec_cache_alloc(size_t *size) {
+	unsigned c = class_of(*size);
+	if (!g_cache.max_bytes || c > MAX_CLASS)
+		return carena_alloc(*size);
+	*size = (size_t)1 << c;
+	struct cached *block = g_cache.lists[c - MIN_CLASS];
+	if (!block)
+		return carena_alloc(*size);
+	g_cache.lists[c - MIN_CLASS] = block->next;
+	g_cache.counts[c - MIN_CLASS]--;
+	g_cache.bytes -= *size;
+	return block;
+}
+
+/** Frees a block, keeping it in the cache if it fits a size class exactly
+ * and the limits allow it.
+ * \param block A pointer to the block.
+ * \param size The allocated size of the block. */
+void cvec_cache_free(void *block, size_t size) {
+	unsigned c = class_of(size);
+	if (
+		!g_cache.max_bytes || c > MAX_CLASS || size != (size_t)1 << c ||
+		g_cache.counts[c - MIN_CLASS] >= g_cache.max_blocks ||
+		size > g_cache.max_bytes - g_cache.bytes
+	) {
+		carena_free(block);
+		return;
+	}
+	struct cached *cached = block;
+	cached->next = g_cache.lists[c - MIN_CLASS];
+	g_cache.lists[c - MIN_CLASS] = cached;
+	g_cache.counts[c - MIN_CLASS]++;
+	g_cache.bytes += size;
+}
+
+/** Frees every block of a cache. */
+static void trim(struct cache *cache) {
+	for (unsigned i = 0; i < NUM_CLASSES; i++) {
+		while (cache->lists[i]) {
+			struct cached *next = cache->lists[i]->next;
+			carena_free(cache->lists[i]);
+			cache->lists[i] = next;
+		}
+		cache->counts[i] = 0;
+	}
+	cache->bytes = 0;
+}
+
+/** Trims and disables the cache of an exiting thread, so blocks freed by 
+ * later destructors go straight to the allocator. */
+static void destroy(void *cache) {
+	struct cache *c = cache;
+	trim(c);
+	c->max_bytes = 0;
+	c->registered = false;
+}
+
+/** Creates the key whose destructor trims the caches of exiting threads. */
+static void create_key() {
+	g_key_created = !pthread_key_create(&g_key, destroy);
+}
+
+/** Frees every block cached by the calling thread.
+ * \details This also happens automatically when the thread exits. */
+void cvec_cache_trim() {
+	trim(&g_cache);
+}
+
+/** Sets the limits of the calling thread's cache.
+ * \details Blocks already cached above the new limits are freed.
+ * \param max_bytes The maximum total size of the cached blocks 
+ * (0 disables the cache).
+ * \param max_blocks The maximum number of cached blocks per size class. */
+void cvec_cache_set_limits(size_t max_bytes, size_t max_blocks) {
+	if (max_bytes && !g_cache.registered) {
+		pthread_once(&g_key_once, create_key);
+		g_cache.registered =
+			g_key_created && !pthread_setspecific(g_key, &g_cache);
+	}
+	g_cache.max_bytes = max_bytes;
+	g_cache.max_blocks = max_blocks;
+	if (g_cache.bytes > max_bytes)
+		cvec_cache_trim();
+	for (unsigned i = 0; i < NUM_CLASSES; i++) {
+		while (g_cache.counts[i] > max_blocks) {
+			struct cached *next = g_cache.lists[i]->next;
+			carena_free(g_cache.lists[i]);
+			g_cache.lists[i] = next;
+			g_cache.counts[i]--;
+			g_cache.bytes -= (size_t)1 << (i + MIN_CLASS);
+		}
+	}
+}
+
+/** Returns the total size of the blocks cached by the calling thread.
+ * \return The size in bytes. */
+size_t cvec_cache_size() {
+	return g_cache.bytes;
+}
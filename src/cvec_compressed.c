@@ -0,0 +1,363 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/cvec_compressed.c
+ * \brief Implementation for the cvec compressed integer vector.
+ * \details This file contains the definition of the compressed vector 
+ * object and the implementations of its public functions. The values are
+ * split into blocks of CVEC_COMPRESSED_BLOCK_LEN. Each block is bit-packed
+ * either as offsets from its minimum (frame of reference) or as the 
+ * deltas between neighbouring values offset from the smallest delta, 
+ * whichever needs fewer bits. A block header stores the word offset of 
+ * the packed bits, which makes random access a single header lookup. */
+
+#include "cvec_private.h"
+#include <carena.h>
+#include <string.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/** Block encoded as offsets from the smallest value. */
+#define MODE_FOR 0
+
+/** Block encoded as offsets from the smallest delta. */
+#define MODE_DELTA 1
+
+/** Header of a block of packed values. */
+struct block {
+	/** Word offset of the packed bits of the block. */
+	size_t offset;
+
+	/** The first value of the block. */
+	int64_t first;
+
+	/** The smallest value (MODE_FOR) or the smallest delta (MODE_DELTA). */
+	int64_t reference;
+
+	/** The number of bits per packed value. */
+	unsigned char width;
+
+	/** MODE_FOR or MODE_DELTA. */
+	unsigned char mode;
+};
+
+/** Opaque handle for the compressed vector object. */
+struct cvec_compressed {
+	/** Vector of the block headers. */
+	cvec_t *blocks;
+
+	/** Vector of the packed 64 bit words (followed by one padding word so 
+	 * that unpacking can always read the word after the current one). */
+	cvec_t *words;
+
+	/** The number of values. */
+	size_t len;
+};
+
+/** Returns the number of bits needed to hold a range of values. */
+static inline unsigned width_for(uint64_t range) {
+	return range ? 64 - (unsigned)__builtin_clzll(range) : 0;
+}
+
+/** Returns the mask of the low width bits. */
+static inline uint64_t width_mask(unsigned width) {
+	return width == 64 ? ~(uint64_t)0 : ((uint64_t)1 << width) - 1;
+}
+
+/** Extracts the packed value starting at a bit position. */
+static inline uint64_t extract(const uint64_t *words, size_t bit, uint64_t mask) {
+	size_t shift = bit % 64;
+	uint64_t lo = words[bit / 64] >> shift;
+	uint64_t hi = (words[bit / 64 + 1] << 1) << (63 - shift);
+	return (lo | hi) & mask;
+}
+
+/** Unpacks the first n values of a block. */
+static void unpack(const uint64_t *words, unsigned width, size_t n, uint64_t *out) {
+	if (!width) {
+		memset(out, 0, n * sizeof(uint64_t));
+		return;
+	}
+	uint64_t mask = width_mask(width);
+	size_t i = 0;
+#ifdef __AVX2__
+	const __m256i vmask = _mm256_set1_epi64x((long long)mask);
+	const __m256i low6 = _mm256_set1_epi64x(63);
+	const __m256i one = _mm256_set1_epi64x(1);
+	const __m256i step = _mm256_set1_epi64x(4 * (long long)width);
+	__m256i bits = _mm256_setr_epi64x(
+		0, (long long)width, 2 * (long long)width, 3 * (long long)width);
+	for (; i + 4 <= n; i += 4) {
+		__m256i index = _mm256_srli_epi64(bits, 6);
+		__m256i shift = _mm256_and_si256(bits, low6);
+		__m256i lo = _mm256_i64gather_epi64((const long long*)words, index, 8);
+		__m256i hi = _mm256_i64gather_epi64(
+			(const long long*)words, _mm256_add_epi64(index, one), 8);
+		lo = _mm256_srlv_epi64(lo, shift);
+		hi = _mm256_sllv_epi64(
+			_mm256_slli_epi64(hi, 1), _mm256_sub_epi64(low6, shift));
+		_mm256_storeu_si256(
+			(__m256i*)&out[i], _mm256_and_si256(_mm256_or_si256(lo, hi), vmask));
+		bits = _mm256_add_epi64(bits, step);
+	}
+#endif
+	for (; i < n; i++)
+		out[i] = extract(words, i * width, mask);
+}
+
+/** Returns the number of values in a block. */
+static inline size_t block_len(const cvec_compressed_t *c, size_t block) {
+	size_t begin = block * CVEC_COMPRESSED_BLOCK_LEN;
+	return c->len - begin < CVEC_COMPRESSED_BLOCK_LEN ?
+		c->len - begin : CVEC_COMPRESSED_BLOCK_LEN;
+}
+
+/** Decodes a whole block. */
+static void decode_block(const cvec_compressed_t *c, size_t block, int64_t *out) {
+	const struct block *header = &((const struct block*)c->blocks->layout.data)[block];
+	const uint64_t *words = &((const uint64_t*)c->words->layout.data)[header->offset];
+	size_t n = block_len(c, block);
+	uint64_t *raw = (uint64_t*)out;
+	if (header->mode == MODE_FOR) {
+		unpack(words, header->width, n, raw);
+		for (size_t i = 0; i < n; i++)
+			raw[i] += (uint64_t)header->reference;
+	} else {
+		unpack(words, header->width, n - 1, &raw[1]);
+		raw[0] = (uint64_t)header->first;
+		for (size_t i = 1; i < n; i++)
+			raw[i] += raw[i - 1] + (uint64_t)header->reference;
+	}
+}
+
+/** Appends a block of values to a compressed vector.
+ * \return false on failure. */
+static bool encode_block(cvec_compressed_t *c, const int64_t *values, size_t n) {
+	int64_t min = values[0], max = values[0];
+	for (size_t i = 1; i < n; i++) {
+		min = values[i] < min ? values[i] : min;
+		max = values[i] > max ? values[i] : max;
+	}
+	int64_t min_delta = 0, max_delta = 0;
+	for (size_t i = 1; i < n; i++) {
+		int64_t delta = (int64_t)((uint64_t)values[i] - (uint64_t)values[i - 1]);
+		min_delta = i == 1 || delta < min_delta ? delta : min_delta;
+		max_delta = i == 1 || delta > max_delta ? delta : max_delta;
+	}
+	unsigned for_width = width_for((uint64_t)max - (uint64_t)min);
+	unsigned delta_width = width_for((uint64_t)max_delta - (uint64_t)min_delta);
+	struct block header = {
+		.offset = c->words->layout.len - 1,
+		.first = values[0],
+	};
+	if (n > 1 && delta_width * (n - 1) < for_width * n) {
+		header.mode = MODE_DELTA;
+		header.width = (unsigned char)delta_width;
+		header.reference = min_delta;
+	} else {
+		header.mode = MODE_FOR;
+		header.width = (unsigned char)for_width;
+		header.reference = min;
+	}
+	size_t packed = header.mode == MODE_FOR ? n : n - 1;
+	size_t count = (packed * header.width + 63) / 64;
+	/* The padding word of the previous block becomes the first word of 
+	 * this one and a new padding word goes after it. */
+	if (!cvec_grow_zeroed(c->words, c->words->layout.len + count))
+		return false;
+	uint64_t *words = &((uint64_t*)c->words->layout.data)[header.offset];
+	for (size_t i = 0; i < packed && header.width; i++) {
+		uint64_t value = header.mode == MODE_FOR ?
+			(uint64_t)values[i] - (uint64_t)min :
+			(uint64_t)values[i + 1] - (uint64_t)values[i] - (uint64_t)min_delta;
+		size_t bit = i * header.width;
+		words[bit / 64] |= value << (bit % 64);
+		if (bit % 64 + header.width > 64)
+			words[bit / 64 + 1] |= value >> (64 - bit % 64);
+	}
+	size_t blocks = c->blocks->layout.len;
+	cvec_push_back(c->blocks, &header, sizeof(struct block));
+	return c->blocks->layout.len == blocks + 1;
+}
+
+/** Deletes a compressed vector instance.
+ * \param c A pointer to the compressed vector to be deleted. */
+void cvec_compressed_del(cvec_compressed_t *c) {
+	if (!c) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	if (c->blocks)
+		cvec_del(c->blocks);
+	if (c->words)
+		cvec_del(c->words);
+	carena_free(c);
+}
+
+/** Compresses a vector of int64_t.
+ * \param vec A pointer to the vector to be compressed.
+ * \return A pointer to the allocated compressed vector. */
+cvec_compressed_t *cvec_compress(const cvec_t *vec) {
+	if (!vec || !vec->layout.data || vec->sizeof_type != sizeof(int64_t)) {
+		cvec_g_err = "Invalid argument.";
+		return NULL;
+	}
+	cvec_compressed_t *c = carena_alloc(sizeof(cvec_compressed_t));
+	if (!c) {
+		cvec_g_err = "Failed to allocate compressed vector.";
+		return NULL;
+	}
+	c->len = 0;
+	c->blocks = cvec_new(sizeof(struct block));
+	c->words = cvec_new(sizeof(uint64_t));
+	if (!c->blocks || !c->words || !cvec_grow_zeroed(c->words, 1)) {
+		cvec_compressed_del(c);
+		return NULL;
+	}
+	const int64_t *values = vec->layout.data;
+	for (size_t i = 0; i < vec->layout.len; i += CVEC_COMPRESSED_BLOCK_LEN) {
+		size_t n = vec->layout.len - i < CVEC_COMPRESSED_BLOCK_LEN ?
+			vec->layout.len - i : CVEC_COMPRESSED_BLOCK_LEN;
+		if (!encode_block(c, &values[i], n)) {
+			cvec_compressed_del(c);
+			return NULL;
+		}
+		c->len += n;
+	}
+	if (!cvec_shrink_to_fit(c->blocks) || !cvec_shrink_to_fit(c->words)) {
+		cvec_compressed_del(c);
+		return NULL;
+	}
+	return c;
+}
+
+/** Decompresses a compressed vector into a new vector of int64_t.
+ * \param c A pointer to the compressed vector to be decompressed.
+ * \return A pointer to the allocated vector. */
+cvec_t *cvec_decompress(const cvec_compressed_t *c) {
+	if (!c || !c->blocks) {
+		cvec_g_err = "Invalid argument.";
+		return NULL;
+	}
+	cvec_t *vec = cvec_new(sizeof(int64_t));
+	if (!vec)
+		return NULL;
+	if (!cvec_grow_zeroed(vec, c->len)) {
+		cvec_del(vec);
+		return NULL;
+	}
+	for (size_t block = 0; block < c->blocks->layout.len; block++)
+		decode_block(c, block, &((int64_t*)vec->layout.data)[block * CVEC_COMPRESSED_BLOCK_LEN]);
+	return vec;
+}
+
+/** Returns the number of values in a compressed vector.
+ * \param c A pointer to the compressed vector to be accessed.
+ * \return The number of values or (size_t)-1 on failure. */
+size_t cvec_compressed_len(const cvec_compressed_t *c) {
+	if (!c) {
+		cvec_g_err = "Invalid argument.";
+		return (size_t)-1;
+	}
+	return c->len;
+}
+
+/** Returns the number of bytes a compressed vector occupies.
+ * \param c A pointer to the compressed vector to be accessed.
+ * \return The number of bytes or (size_t)-1 on failure. */
+size_t cvec_compressed_bytes(const cvec_compressed_t *c) {
+	if (!c || !c->blocks) {
+		cvec_g_err = "Invalid argument.";
+		return (size_t)-1;
+	}
+	return sizeof(cvec_compressed_t) + 2 * sizeof(cvec_t) +
+		c->blocks->capacity * c->blocks->sizeof_type +
+		c->words->capacity * c->words->sizeof_type;
+}
+
+/** Returns a value of a compressed vector.
+ * \param c A pointer to the compressed vector to be accessed.
+ * \param index The index of the value.
+ * \return The value (0 on failure). */
+int64_t cvec_compressed_get(const cvec_compressed_t *c, size_t index) {
+	if (!c || !c->blocks) {
+		cvec_g_err = "Invalid argument.";
+		return 0;
+	}
+	if (index >= c->len) {
+		cvec_g_err = "Index is out of bounds.";
+		return 0;
+	}
+	const struct block *header = 
+		&((const struct block*)c->blocks->layout.data)[index / CVEC_COMPRESSED_BLOCK_LEN];
+	const uint64_t *words = &((const uint64_t*)c->words->layout.data)[header->offset];
+	size_t i = index % CVEC_COMPRESSED_BLOCK_LEN;
+	uint64_t mask = width_mask(header->width);
+	if (header->mode == MODE_FOR)
+		return (int64_t)((uint64_t)header->reference +
+			(header->width ? extract(words, i * header->width, mask) : 0));
+	uint64_t value = (uint64_t)header->first + i * (uint64_t)header->reference;
+	for (size_t j = 0; j < i && header->width; j++)
+		value += extract(words, j * header->width, mask);
+	return (int64_t)value;
+}
+
+/** Decodes a range of values of a compressed vector.
+ * \details Decoding is fastest when index is a multiple of 
+ * CVEC_COMPRESSED_BLOCK_LEN, which is what sequential iteration with a
+ * buffer of that many values does.
+ * \param c A pointer to the compressed vector to be accessed.
+ * \param index The index of the first value to be decoded.
+ * \param out The array receiving the values.
+ * \param len The maximum number of values to be decoded.
+ * \return The number of values decoded (0 at the end or on failure). */
+size_t cvec_compressed_decode(
+	const cvec_compressed_t *c, size_t index, int64_t *out, size_t len)
+{
+	if (!c || !c->blocks || (len && !out)) {
+		cvec_g_err = "Invalid argument.";
+		return 0;
+	}
+	if (index >= c->len)
+		return 0;
+	if (len > c->len - index)
+		len = c->len - index;
+	int64_t buf[CVEC_COMPRESSED_BLOCK_LEN];
+	size_t done = 0;
+	while (done < len) {
+		size_t block = (index + done) / CVEC_COMPRESSED_BLOCK_LEN;
+		size_t skip = (index + done) % CVEC_COMPRESSED_BLOCK_LEN;
+		size_t n = block_len(c, block) - skip;
+		n = n < len - done ? n : len - done;
+		if (!skip && n == block_len(c, block)) {
+			decode_block(c, block, &out[done]);
+		} else {
+			decode_block(c, block, buf);
+			memcpy(&out[done], &buf[skip], n * sizeof(int64_t));
+		}
+		done += n;
+	}
+	return len;
+}
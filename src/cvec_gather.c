@@ -0,0 +1,222 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/cvec_gather.c
+ * \brief Implementation for the cvec gather, scatter, and permute functions.
+ * \details The copy loops are specialized for 4, 8, and 16 byte items so 
+ * each item is moved by a single load and store, and the item a fixed 
+ * distance ahead is prefetched to hide the latency of the random accesses.
+ * Large operations are split over several threads. */
+
+#include "cvec_private.h"
+#include <string.h>
+
+/** The number of items ahead of the current one that are prefetched. */
+#define PREFETCH_DISTANCE 16
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(addr, rw) __builtin_prefetch((addr), (rw))
+#else
+#define PREFETCH(addr, rw) ((void)(addr))
+#endif
+
+/** Context of a parallel gather or scatter. */
+struct move_ctx {
+	/** The data items are copied to. */
+	unsigned char *dst;
+
+	/** The data items are copied from. */
+	const unsigned char *src;
+
+	/** The indices into src (gather) or dst (scatter). */
+	const size_t *idx;
+
+	/** The size of the items. */
+	size_t size;
+};
+
+/** Copies src[idx[i]] to dst[i] for i in [begin, end). Inlined with a 
+ * constant size it compiles to plain loads and stores. */
+static inline void gather_items(
+	unsigned char *restrict dst, const unsigned char *restrict src,
+	const size_t *idx, size_t begin, size_t end, size_t size)
+{
+	size_t i = begin;
+	for (; i + PREFETCH_DISTANCE < end; i++) {
+		PREFETCH(&src[idx[i + PREFETCH_DISTANCE] * size], 0);
+		memcpy(&dst[i * size], &src[idx[i] * size], size);
+	}
+	for (; i < end; i++)
+		memcpy(&dst[i * size], &src[idx[i] * size], size);
+}
+
+/** Copies src[i] to dst[idx[i]] for i in [begin, end). Inlined with a 
+ * constant size it compiles to plain loads and stores. */
+static inline void scatter_items(
+	unsigned char *restrict dst, const unsigned char *restrict src,
+	const size_t *idx, size_t begin, size_t end, size_t size)
+{
+	size_t i = begin;
+	for (; i + PREFETCH_DISTANCE < end; i++) {
+		PREFETCH(&dst[idx[i + PREFETCH_DISTANCE] * size], 1);
+		memcpy(&dst[idx[i] * size], &src[i * size], size);
+	}
+	for (; i < end; i++)
+		memcpy(&dst[idx[i] * size], &src[i * size], size);
+}
+
+/** Gathers the items [begin, end) of a parallel gather. */
+static void gather_chunk(void *ctx, size_t begin, size_t end) {
+	struct move_ctx *m = ctx;
+	switch (m->size) {
+		case 4: gather_items(m->dst, m->src, m->idx, begin, end, 4); break;
+		case 8: gather_items(m->dst, m->src, m->idx, begin, end, 8); break;
+		case 16: gather_items(m->dst, m->src, m->idx, begin, end, 16); break;
+		default: gather_items(m->dst, m->src, m->idx, begin, end, m->size);
+	}
+}
+
+/** Scatters the items [begin, end) of a parallel scatter. */
+static void scatter_chunk(void *ctx, size_t begin, size_t end) {
+	struct move_ctx *m = ctx;
+	switch (m->size) {
+		case 4: scatter_items(m->dst, m->src, m->idx, begin, end, 4); break;
+		case 8: scatter_items(m->dst, m->src, m->idx, begin, end, 8); break;
+		case 16: scatter_items(m->dst, m->src, m->idx, begin, end, 16); break;
+		default: scatter_items(m->dst, m->src, m->idx, begin, end, m->size);
+	}
+}
+
+/** Runs a gather or scatter of len items, on several threads if it moves
+ * more than CVEC_PARALLEL_THRESHOLD bytes. */
+static void run(cvec_parallel_fn fn, struct move_ctx *ctx, size_t len) {
+	if (len * ctx->size < CVEC_PARALLEL_THRESHOLD) {
+		fn(ctx, 0, len);
+		return;
+	}
+	cvec_parallel_for(
+		len, CVEC_PARALLEL_THRESHOLD / CVEC_MAX_THREADS / ctx->size, fn, ctx);
+}
+
+/** Returns whether all len indices are below bound. */
+static bool in_bounds(const size_t *idx, size_t len, size_t bound) {
+	bool ok = true;
+	for (size_t i = 0; i < len; i++)
+		ok &= idx[i] < bound;
+	return ok;
+}
+
+/** Gathers already validated indices into dst. */
+static void gather(cvec_t *dst, const cvec_t *src, const size_t *idx, size_t len) {
+	if (!cvec_reset_len(dst, len))
+		return;
+	struct move_ctx ctx = {
+		.dst = dst->layout.data,
+		.src = src->layout.data,
+		.idx = idx,
+		.size = src->sizeof_type,
+	};
+	run(gather_chunk, &ctx, len);
+}
+
+/** Replaces the contents of a vector with items selected from another one.
+ * \details Afterwards dst[i] is src[idx[i]] for every i below len. 
+ * \param dst A pointer to the vector to be overwritten.
+ * \param src A pointer to the vector to be selected from (must be a 
+ * different vector of the same type).
+ * \param idx The indices of the selected items (may repeat).
+ * \param len The number of indices. */
+void cvec_gather(cvec_t *dst, const cvec_t *src, const size_t *idx, size_t len) {
+	if (!dst || !dst->layout.data || !src || !src->layout.data || dst == src ||
+		dst->sizeof_type != src->sizeof_type || (!idx && len))
+	{
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	if (!in_bounds(idx, len, src->layout.len)) {
+		cvec_g_err = "Index is out of bounds.";
+		return;
+	}
+	gather(dst, src, idx, len);
+}
+
+/** Writes the items of a vector to given positions of another one.
+ * \details Afterwards dst[idx[i]] is src[i] for every i below the length
+ * of src. 
+ * \param dst A pointer to the vector to be written to.
+ * \param src A pointer to the vector to be read from (must be a different 
+ * vector of the same type).
+ * \param idx The positions in dst, one for each item of src. They should 
+ * be distinct; which item ends up at a repeated position is unspecified. */
+void cvec_scatter(cvec_t *dst, const cvec_t *src, const size_t *idx) {
+	if (!dst || !dst->layout.data || !src || !src->layout.data || dst == src ||
+		dst->sizeof_type != src->sizeof_type || (!idx && src->layout.len))
+	{
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	if (!in_bounds(idx, src->layout.len, dst->layout.len)) {
+		cvec_g_err = "Index is out of bounds.";
+		return;
+	}
+	if (!cvec_detach(dst))
+		return;
+	struct move_ctx ctx = {
+		.dst = dst->layout.data,
+		.src = src->layout.data,
+		.idx = idx,
+		.size = src->sizeof_type,
+	};
+	run(scatter_chunk, &ctx, src->layout.len);
+}
+
+/** Reorders the items of a vector.
+ * \details Afterwards vec[i] is the former vec[perm[i]] for every i below 
+ * the length of the vector. The items are gathered into a new buffer that
+ * then replaces the old one, which is much faster on large vectors than 
+ * following the cycles of the permutation in place. 
+ * \param vec A pointer to the vector to be reordered.
+ * \param perm One index per item (typically a permutation, as returned by
+ * an argsort). */
+void cvec_permute(cvec_t *vec, const size_t *perm) {
+	if (!vec || !vec->layout.data || (!perm && vec->layout.len)) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	if (!in_bounds(perm, vec->layout.len, vec->layout.len)) {
+		cvec_g_err = "Index is out of bounds.";
+		return;
+	}
+	cvec_t *tmp = cvec_new_aligned(vec->sizeof_type, vec->alignment);
+	if (!tmp)
+		return;
+	tmp->huge_pages = vec->huge_pages;
+	gather(tmp, vec, perm, vec->layout.len);
+	if (tmp->layout.len != vec->layout.len) {
+		cvec_del(tmp);
+		return;
+	}
+	cvec_swap(vec, tmp);
+	cvec_del(tmp);
+}
@@ -0,0 +1,527 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/cvec_map.c
+ * \brief Implementation for the cvec hash map.
+ * \details This file contains the definition of the hash map object and 
+ * the implementations of its public functions. The map is an open-addressing
+ * table with one control byte per slot. Slots are probed a group of control
+ * bytes at a time, which is a single SSE2 compare where available. */
+
+#include "cvec_private.h"
+#include <carena.h>
+#include <string.h>
+#include <stdint.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/** The number of control bytes probed at once. */
+#define GROUP_WIDTH 16
+
+/** Control byte of a slot that has never been used. */
+#define CTRL_EMPTY ((int8_t)-128)
+
+/** Control byte of a slot whose entry has been removed. */
+#define CTRL_DELETED ((int8_t)-2)
+
+/** Index returned by the lookup when the key is not present. */
+#define NOT_FOUND ((size_t)-1)
+
+/** Opaque handle for the hash map object. */
+struct cvec_map {
+	/** One control byte per slot: CTRL_EMPTY, CTRL_DELETED, or the 7 low
+	 * bits of the hash of the key stored in the slot. */
+	int8_t *ctrl;
+
+	/** Pointer to the keys. */
+	unsigned char *keys;
+
+	/** Pointer to the values (NULL for a hash set). */
+	unsigned char *values;
+
+	/** The size of the key type. */
+	size_t sizeof_key;
+
+	/** The size of the value type. */
+	size_t sizeof_value;
+
+	/** The number of slots (a power of two multiple of GROUP_WIDTH). */
+	size_t capacity;
+
+	/** The number of entries. */
+	size_t len;
+
+	/** The number of empty slots that can be filled before rehashing. */
+	size_t growth_left;
+
+	/** The hash function or NULL to hash the bytes of the key. */
+	cvec_map_hash_fn hash;
+
+	/** The equality function or NULL to compare the bytes of the key. */
+	cvec_map_eq_fn eq;
+};
+
+/** Returns the bitmask of the slots in a group whose control byte is h2. */
+static inline unsigned group_match(const int8_t *group, int8_t h2) {
+#ifdef __SSE2__
+	__m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+	return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)));
+#else
+	unsigned mask = 0;
+	for (unsigned i = 0; i < GROUP_WIDTH; i++)
+		if (group[i] == h2)
+			mask |= 1u << i;
+	return mask;
+#endif
+}
+
+/** Returns the bitmask of the slots in a group that are empty or deleted. */
+static inline unsigned group_match_free(const int8_t *group) {
+#ifdef __SSE2__
+	return (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+	unsigned mask = 0;
+	for (unsigned i = 0; i < GROUP_WIDTH; i++)
+		if (group[i] < 0)
+			mask |= 1u << i;
+	return mask;
+#endif
+}
+
+/** Returns the number of entries a given number of slots can hold. */
+static inline size_t max_load(size_t capacity) {
+	return capacity - capacity / 8;
+}
+
+/** Returns the smallest valid number of slots that can hold len entries,
+ * or 0 if that number would overflow size_t. */
+static size_t capacity_for(size_t len) {
+	size_t capacity = GROUP_WIDTH;
+	while (max_load(capacity) < len) {
+		if (capacity > SIZE_MAX / 2)
+			return 0;
+		capacity *= 2;
+	}
+	return capacity;
+}
+
+/** Hashes the bytes of a key. */
+static uint64_t hash_bytes(const void *key, size_t len) {
+	const unsigned char *bytes = key;
+	uint64_t hash = 0xcbf29ce484222325ull ^ len;
+	for (; len >= 8; len -= 8, bytes += 8) {
+		uint64_t word;
+		memcpy(&word, bytes, 8);
+		hash = (hash ^ word) * 0x100000001b3ull;
+		hash ^= hash >> 29;
+	}
+	for (; len; len--, bytes++)
+		hash = (hash ^ *bytes) * 0x100000001b3ull;
+	return hash;
+}
+
+/** Hashes a key with the map's hash function and mixes the result so that
+ * weak hash functions (such as the identity) still spread over the slots. */
+static inline uint64_t map_hash(const cvec_map_t *map, const void *key) {
+	uint64_t hash = map->hash ?
+		(uint64_t)map->hash(key) : hash_bytes(key, map->sizeof_key);
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+/** Compares a key with the key stored in a slot. */
+static inline bool map_eq(const cvec_map_t *map, const void *key, size_t slot) {
+	const void *stored = &map->keys[slot * map->sizeof_key];
+	return map->eq ?
+		map->eq(key, stored) : !memcmp(key, stored, map->sizeof_key);
+}
+
+/** Returns the slot holding a key or NOT_FOUND. */
+static size_t map_find(const cvec_map_t *map, const void *key, uint64_t hash) {
+	size_t mask = map->capacity / GROUP_WIDTH - 1;
+	size_t group = (size_t)(hash >> 7) & mask;
+	int8_t h2 = (int8_t)(hash & 0x7f);
+	for (size_t step = 1; step <= mask + 1; step++) {
+		const int8_t *ctrl = &map->ctrl[group * GROUP_WIDTH];
+		for (unsigned match = group_match(ctrl, h2); match; match &= match - 1) {
+			size_t slot = group * GROUP_WIDTH + (size_t)__builtin_ctz(match);
+			if (map_eq(map, key, slot))
+				return slot;
+		}
+		if (group_match(ctrl, CTRL_EMPTY))
+			break;
+		group = (group + step) & mask;
+	}
+	return NOT_FOUND;
+}
+
+/** Returns the first empty or deleted slot on the probe sequence of a hash. */
+static size_t map_find_free(const cvec_map_t *map, uint64_t hash) {
+	size_t mask = map->capacity / GROUP_WIDTH - 1;
+	size_t group = (size_t)(hash >> 7) & mask;
+	for (size_t step = 1;; step++) {
+		unsigned match = group_match_free(&map->ctrl[group * GROUP_WIDTH]);
+		if (match)
+			return group * GROUP_WIDTH + (size_t)__builtin_ctz(match);
+		group = (group + step) & mask;
+	}
+}
+
+/** Moves every entry of a map into a freshly allocated set of slots.
+ * \return false on allocation failure (the map is left untouched). */
+static bool map_resize(cvec_map_t *map, size_t capacity) {
+	size_t max_size = map->sizeof_key > map->sizeof_value ?
+		map->sizeof_key : map->sizeof_value;
+	if (!capacity || (max_size && capacity > SIZE_MAX / max_size)) {
+		cvec_g_err = "Map is too large.";
+		return false;
+	}
+	int8_t *ctrl = carena_alloc(capacity);
+	unsigned char *keys = carena_alloc(capacity * map->sizeof_key);
+	unsigned char *values = map->sizeof_value ?
+		carena_alloc(capacity * map->sizeof_value) : NULL;
+	if (!ctrl || !keys || (map->sizeof_value && !values)) {
+		if (ctrl) carena_free(ctrl);
+		if (keys) carena_free(keys);
+		if (values) carena_free(values);
+		cvec_g_err = "Failed to resize map.";
+		return false;
+	}
+	memset(ctrl, (unsigned char)CTRL_EMPTY, capacity);
+	cvec_map_t old = *map;
+	map->ctrl = ctrl;
+	map->keys = keys;
+	map->values = values;
+	map->capacity = capacity;
+	map->growth_left = max_load(capacity) - map->len;
+	if (old.ctrl) {
+		for (size_t i = 0; i < old.capacity; i++) {
+			if (old.ctrl[i] < 0)
+				continue;
+			const void *key = &old.keys[i * old.sizeof_key];
+			uint64_t hash = map_hash(map, key);
+			size_t slot = map_find_free(map, hash);
+			map->ctrl[slot] = (int8_t)(hash & 0x7f);
+			memcpy(&map->keys[slot * map->sizeof_key], key, map->sizeof_key);
+			if (map->sizeof_value)
+				memcpy(
+					&map->values[slot * map->sizeof_value],
+					&old.values[i * old.sizeof_value],
+					map->sizeof_value);
+		}
+		carena_free(old.ctrl);
+		carena_free(old.keys);
+		if (old.values)
+			carena_free(old.values);
+	}
+	return true;
+}
+
+/** Creates a new open-addressing hash map for specific key and value types.
+ * \param sizeof_key The size of the key type.
+ * \param sizeof_value The size of the value type (0 for a hash set).
+ * \param hash The hash function or NULL to hash the bytes of the key.
+ * \param eq The equality function or NULL to compare the bytes of the key.
+ * \return A pointer to the allocated hash map. */
+cvec_map_t *cvec_map_new(
+	size_t sizeof_key, size_t sizeof_value,
+	cvec_map_hash_fn hash, cvec_map_eq_fn eq)
+{
+	if (!sizeof_key) {
+		cvec_g_err = "Invalid argument.";
+		return NULL;
+	}
+	cvec_map_t *map = carena_alloc(sizeof(cvec_map_t));
+	if (!map) {
+		cvec_g_err = "Failed to allocate map.";
+		return NULL;
+	}
+	memset(map, 0, sizeof(cvec_map_t));
+	map->sizeof_key = sizeof_key;
+	map->sizeof_value = sizeof_value;
+	map->hash = hash;
+	map->eq = eq;
+	if (!map_resize(map, GROUP_WIDTH)) {
+		carena_free(map);
+		cvec_g_err = "Failed to allocate map data.";
+		return NULL;
+	}
+	return map;
+}
+
+/** Deletes a hash map instance.
+ * \param map A pointer to the hash map to be deleted. */
+void cvec_map_del(cvec_map_t *map) {
+	if (!map || !map->ctrl) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	carena_free(map->ctrl);
+	carena_free(map->keys);
+	if (map->values)
+		carena_free(map->values);
+	carena_free(map);
+}
+
+/** Returns the number of entries in a hash map.
+ * \param map A pointer to the hash map to be accessed.
+ * \return The number of entries or (size_t)-1 on failure. */
+size_t cvec_map_len(const cvec_map_t *map) {
+	if (!map) {
+		cvec_g_err = "Invalid argument.";
+		return (size_t)-1;
+	}
+	return map->len;
+}
+
+/** Returns the number of slots in a hash map.
+ * \param map A pointer to the hash map to be accessed.
+ * \return The number of slots or (size_t)-1 on failure. */
+size_t cvec_map_capacity(const cvec_map_t *map) {
+	if (!map) {
+		cvec_g_err = "Invalid argument.";
+		return (size_t)-1;
+	}
+	return map->capacity;
+}
+
+/** Makes room for at least len entries without further rehashing.
+ * \param map A pointer to the hash map to be modified.
+ * \param len The number of entries to make room for. */
+void cvec_map_reserve(cvec_map_t *map, size_t len) {
+	if (!map || !map->ctrl) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	if (len <= map->len || len - map->len <= map->growth_left)
+		return;
+	(void)map_resize(map, capacity_for(len));
+}
+
+/** Rebuilds a hash map with at least the requested number of slots.
+ * \details This also drops every tombstone left behind by removals.
+ * \param map A pointer to the hash map to be modified.
+ * \param capacity The requested number of slots. */
+void cvec_map_rehash(cvec_map_t *map, size_t capacity) {
+	if (!map || !map->ctrl) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	size_t min_capacity = capacity_for(map->len);
+	size_t new_capacity = min_capacity ? GROUP_WIDTH : 0;
+	while (new_capacity &&
+		(new_capacity < capacity || new_capacity < min_capacity))
+	{
+		if (new_capacity > SIZE_MAX / 2) {
+			new_capacity = 0;
+			break;
+		}
+		new_capacity *= 2;
+	}
+	(void)map_resize(map, new_capacity);
+}
+
+/** Inserts an entry or replaces the value of an existing one.
+ * \param map A pointer to the hash map to be modified.
+ * \param key A pointer to the key.
+ * \param value A pointer to the value (ignored for a hash set).
+ * \param sizeof_key The size of the map's key type.
+ * \param sizeof_value The size of the map's value type.
+ * \return true if the key was not yet present in the map. */
+bool cvec_map_insert(
+	cvec_map_t *map, const void *key, const void *value,
+	size_t sizeof_key, size_t sizeof_value)
+{
+	if (
+		!map || !map->ctrl || !key || (sizeof_value && !value) ||
+		sizeof_key != map->sizeof_key || sizeof_value != map->sizeof_value
+	) {
+		cvec_g_err = "Invalid argument.";
+		return false;
+	}
+	uint64_t hash = map_hash(map, key);
+	size_t slot = map_find(map, key, hash);
+	if (slot != NOT_FOUND) {
+		if (sizeof_value)
+			memcpy(&map->values[slot * sizeof_value], value, sizeof_value);
+		return false;
+	}
+	slot = map_find_free(map, hash);
+	if (!map->growth_left && map->ctrl[slot] == CTRL_EMPTY) {
+		/* Grow if the map is mostly live entries, otherwise just
+		 * reclaim the tombstones at the current size. */
+		size_t capacity = map->len >= map->capacity / 2 ?
+			map->capacity * 2 : map->capacity;
+		if (!map_resize(map, capacity))
+			return false;
+		slot = map_find_free(map, hash);
+	}
+	if (map->ctrl[slot] == CTRL_EMPTY)
+		map->growth_left--;
+	map->ctrl[slot] = (int8_t)(hash & 0x7f);
+	memcpy(&map->keys[slot * sizeof_key], key, sizeof_key);
+	if (sizeof_value)
+		memcpy(&map->values[slot * sizeof_value], value, sizeof_value);
+	map->len++;
+	return true;
+}
+
+/** Checks whether a key is present in a hash map.
+ * \param map A pointer to the hash map to be accessed.
+ * \param key A pointer to the key to be looked up.
+ * \return true if the key is present. */
+bool cvec_map_contains(const cvec_map_t *map, const void *key) {
+	if (!map || !map->ctrl || !key) {
+		cvec_g_err = "Invalid argument.";
+		return false;
+	}
+	return map_find(map, key, map_hash(map, key)) != NOT_FOUND;
+}
+
+/** Returns a const pointer to the value stored under a key.
+ * \param map A pointer to the hash map to be accessed.
+ * \param key A pointer to the key to be looked up.
+ * \return A const pointer to the value or NULL if the key is not present. */
+const void *cvec_map_view(const cvec_map_t *map, const void *key) {
+	if (!map || !map->ctrl || !map->values || !key) {
+		cvec_g_err = "Invalid argument.";
+		return NULL;
+	}
+	size_t slot = map_find(map, key, map_hash(map, key));
+	if (slot == NOT_FOUND)
+		return NULL;
+	return &map->values[slot * map->sizeof_value];
+}
+
+/** Returns a pointer to the value stored under a key.
+ * \param map A pointer to the hash map to be accessed.
+ * \param key A pointer to the key to be looked up.
+ * \return A pointer to the value or NULL if the key is not present. */
+void *cvec_map_ptr(cvec_map_t *map, const void *key) {
+	return (void*)cvec_map_view(map, key);
+}
+
+/** Removes an entry from a hash map.
+ * \param map A pointer to the hash map to be modified.
+ * \param key A pointer to the key to be removed.
+ * \return true if the key was present. */
+bool cvec_map_remove(cvec_map_t *map, const void *key) {
+	if (!map || !map->ctrl || !key) {
+		cvec_g_err = "Invalid argument.";
+		return false;
+	}
+	size_t slot = map_find(map, key, map_hash(map, key));
+	if (slot == NOT_FOUND)
+		return false;
+	/* Probing stops at the first group with an empty slot, so if this
+	 * group already has one no probe sequence ever continued past it and
+	 * the slot can become empty instead of a tombstone. */
+	const int8_t *group = &map->ctrl[slot / GROUP_WIDTH * GROUP_WIDTH];
+	if (group_match(group, CTRL_EMPTY)) {
+		map->ctrl[slot] = CTRL_EMPTY;
+		map->growth_left++;
+	} else {
+		map->ctrl[slot] = CTRL_DELETED;
+	}
+	map->len--;
+	return true;
+}
+
+/** Removes every entry from a hash map while keeping its slots.
+ * \param map A pointer to the hash map to be modified. */
+void cvec_map_clear(cvec_map_t *map) {
+	if (!map || !map->ctrl) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	memset(map->ctrl, (unsigned char)CTRL_EMPTY, map->capacity);
+	map->len = 0;
+	map->growth_left = max_load(map->capacity);
+}
+
+/** Steps through the entries of a hash map in slot order.
+ * \param map A pointer to the hash map to be accessed.
+ * \param iter A pointer to the iterator (must be 0 before the first call).
+ * \param key Receives a const pointer to the key of the entry.
+ * \param value Receives a const pointer to the value of the entry 
+ * (may be NULL).
+ * \return false once there are no more entries. */
+bool cvec_map_next(
+	const cvec_map_t *map, size_t *iter, const void **key, const void **value)
+{
+	if (!map || !map->ctrl || !iter || !key) {
+		cvec_g_err = "Invalid argument.";
+		return false;
+	}
+	for (size_t slot = *iter; slot < map->capacity; slot++) {
+		if (map->ctrl[slot] < 0)
+			continue;
+		*key = &map->keys[slot * map->sizeof_key];
+		if (value)
+			*value = map->values ?
+				&map->values[slot * map->sizeof_value] : NULL;
+		*iter = slot + 1;
+		return true;
+	}
+	*iter = map->capacity;
+	return false;
+}
+
+/** Removes duplicate items from a vector keeping their first occurrence.
+ * \param vec A pointer to the vector to be modified.
+ * \param hash The hash function or NULL to hash the bytes of the items.
+ * \param eq The equality function or NULL to compare the bytes of the items. */
+void cvec_dedup(cvec_t *vec, cvec_map_hash_fn hash, cvec_map_eq_fn eq) {
+	if (!vec || !vec->layout.data) {
+		cvec_g_err = "Invalid argument.";
+		return;
+	}
+	cvec_map_t *seen = cvec_map_new(vec->sizeof_type, 0, hash, eq);
+	if (!seen)
+		return;
+	/* With every slot reserved up front, insert can only fail on a 
+	 * duplicate, never on a failed allocation. */
+	cvec_map_reserve(seen, vec->layout.len);
+	if (seen->growth_left < vec->layout.len || !cvec_detach(vec)) {
+		cvec_map_del(seen);
+		return;
+	}
+	unsigned char *chardata = (unsigned char*)vec->layout.data;
+	size_t len = 0;
+	for (size_t i = 0; i < vec->layout.len; i++) {
+		unsigned char *item = &chardata[i * vec->sizeof_type];
+		if (!cvec_map_insert(seen, item, NULL, vec->sizeof_type, 0))
+			continue;
+		if (len != i)
+			memcpy(&chardata[len * vec->sizeof_type], item, vec->sizeof_type);
+		len++;
+	}
+	vec->layout.len = len;
+	cvec_map_del(seen);
+}
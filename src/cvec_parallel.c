@@ -0,0 +1,100 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/cvec_parallel.c
+ * \brief Implementation for the cvec parallel loop.
+ * \details This file contains the helper that splits the bulk operations 
+ * of the library over several threads once their buffers are large enough
+ * for the thread start-up cost to pay off. */
+
+#include "cvec_private.h"
+#include <pthread.h>
+#include <unistd.h>
+
+/** A chunk of a parallel loop handed to a thread. */
+struct chunk {
+	/** The function processing the chunk. */
+	cvec_parallel_fn fn;
+
+	/** The context passed to the function. */
+	void *ctx;
+
+	/** The first index of the chunk. */
+	size_t begin;
+
+	/** One past the last index of the chunk. */
+	size_t end;
+};
+
+/** Thread entry point running a chunk. */
+static void *run_chunk(void *arg) {
+	struct chunk *chunk = arg;
+	chunk->fn(chunk->ctx, chunk->begin, chunk->end);
+	return NULL;
+}
+
+/** Runs fn over the range [0, count) split into contiguous chunks.
+ * \details The chunks are processed by up to CVEC_MAX_THREADS threads 
+ * (one of them the caller), and each chunk gets at least min_chunk 
+ * indices. Each thread touches only its own chunk, so freshly allocated 
+ * pages are first touched by the thread that processes them. Chunks whose
+ * thread cannot be started run on the calling thread.
+ * \param count The number of indices.
+ * \param min_chunk The minimum number of indices per chunk.
+ * \param fn The function processing a chunk.
+ * \param ctx The context passed to fn. */
+void cvec_parallel_for(
+	size_t count, size_t min_chunk, cvec_parallel_fn fn, void *ctx)
+{
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t threads = cpus > 0 ? (size_t)cpus : 1;
+	if (threads < CVEC_MIN_THREADS)
+		threads = CVEC_MIN_THREADS;
+	if (threads > CVEC_MAX_THREADS)
+		threads = CVEC_MAX_THREADS;
+	if (min_chunk && threads > count / min_chunk)
+		threads = count / min_chunk;
+	if (threads <= 1) {
+		fn(ctx, 0, count);
+		return;
+	}
+	struct chunk chunks[CVEC_MAX_THREADS];
+	pthread_t ids[CVEC_MAX_THREADS];
+	bool started[CVEC_MAX_THREADS] = {false};
+	for (size_t i = 0; i < threads; i++) {
+		chunks[i].fn = fn;
+		chunks[i].ctx = ctx;
+		chunks[i].begin = count / threads * i;
+		chunks[i].end = i + 1 == threads ? count : count / threads * (i + 1);
+	}
+	for (size_t i = 1; i < threads; i++)
+		started[i] = !pthread_create(&ids[i], NULL, run_chunk, &chunks[i]);
+	run_chunk(&chunks[0]);
+	for (size_t i = 1; i < threads; i++) {
+		if (started[i])
+			pthread_join(ids[i], NULL);
+		else
+			run_chunk(&chunks[i]);
+	}
+}
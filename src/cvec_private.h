@@ -0,0 +1,171 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/cvec_private.h
+ * \brief Private header file for the cvec library.
+ * \details This file contains the definition of the vector object and 
+ * the declarations shared between the translation units of the library. */
+
+#ifndef CVEC_PRIVATE_H
+#define CVEC_PRIVATE_H
+
+#include "cvec.h"
+#include <stdatomic.h>
+
+/** The default capacity of the vector object. */
+#define DEFAULT_CAPACITY 8
+
+/** The size in bytes above which bulk operations run on several threads. */
+#ifndef CVEC_PARALLEL_THRESHOLD
+#define CVEC_PARALLEL_THRESHOLD ((size_t)64 << 20)
+#endif
+
+/** The maximum number of threads a bulk operation runs on. */
+#ifndef CVEC_MAX_THREADS
+#define CVEC_MAX_THREADS 16
+#endif
+
+/** The minimum number of threads a bulk operation runs on, even on 
+ * machines with fewer CPUs (as long as the work can be split). */
+#ifndef CVEC_MIN_THREADS
+#define CVEC_MIN_THREADS 1
+#endif
+
+/** Marks a symbol shared by the translation units of the library but not
+ * exported from the shared object. */
+#if defined(__GNUC__) || defined(__clang__)
+#define CVEC_HIDDEN __attribute__((visibility("hidden")))
+#else
+#define CVEC_HIDDEN
+#endif
+
+/** The latest error message of the calling thread. */
+extern CVEC_HIDDEN _Thread_local const char *cvec_g_err;
+
+/** Opaque handle for the vector object. */
+struct cvec_vector {
+	/** The data, the length, and the reference count of the vector, which
+	 * the public headers can read. It must stay the first member. */
+	struct cvec_layout layout;
+
+	/** Pointer to the allocation holding the data. It only differs from
+	 * data when the data is aligned beyond the allocator's guarantee. */
+	void *block;
+
+	/** The allocated size of the block. */
+	size_t block_size;
+
+	/** The alignment of the data or 0 for the allocator's default. */
+	size_t alignment;
+
+	/** The size of the vector's type. */
+	size_t sizeof_type;
+
+	/** The current capacity of the vector. */
+	size_t capacity;
+
+	/** Whether large data should be backed by transparent huge pages. */
+	bool huge_pages;
+
+	/** Whether this header was allocated at a size class of the cache. It
+	 * belongs to the allocation, so it is not copied between headers. */
+	bool header_in_class;
+};
+
+/** Swaps the contents of two vector headers, leaving each header's own
+ * allocation details in place.
+ * \param a A pointer to the first vector.
+ * \param b A pointer to the second vector. */
+CVEC_HIDDEN void cvec_swap(cvec_t *a, cvec_t *b);
+
+/** Returns the number of vectors sharing the data of a vector or NULL if 
+ * it is not shared. */
+static inline _Atomic size_t *refcount_of(const cvec_t *vec) {
+	return (_Atomic size_t*)vec->layout.shared;
+}
+
+/** Makes sure a vector does not share its data with any snapshot.
+ * \param vec A pointer to the vector to be detached.
+ * \return false on failure. */
+CVEC_HIDDEN bool cvec_detach(cvec_t *vec);
+
+/** Grows a vector to a given length following the doubling growth policy.
+ * The new items are zeroed.
+ * \param vec A pointer to the vector to be grown.
+ * \param len The new length (must not be less than the current one).
+ * \return false on failure. */
+CVEC_HIDDEN bool cvec_grow_zeroed(cvec_t *vec, size_t len);
+
+/** Shrinks the capacity of a vector to its length (but not below the
+ * default capacity).
+ * \param vec A pointer to the vector to be shrunk.
+ * \return false on failure. */
+CVEC_HIDDEN bool cvec_shrink_to_fit(cvec_t *vec);
+
+/** Sets the length of a vector, reallocating it at most once. Items below
+ * both lengths are kept and new items are left uninitialized.
+ * \param vec A pointer to the vector to be modified.
+ * \param len The new length.
+ * \return false on failure. */
+CVEC_HIDDEN bool cvec_set_len(cvec_t *vec, size_t len);
+
+/** Sets the length of a vector, discarding all of its items. The items 
+ * are left uninitialized and are not copied by a reallocation.
+ * \param vec A pointer to the vector to be modified.
+ * \param len The new length.
+ * \return false on failure (the vector is left unchanged). */
+CVEC_HIDDEN bool cvec_reset_len(cvec_t *vec, size_t len);
+
+/** Returns whether the calling thread's cache is enabled. */
+CVEC_HIDDEN bool cvec_cache_enabled();
+
+/** Allocates a block, reusing a cached one if possible.
+ * \param size The requested size. While the cache is enabled it is 
+ * rounded up to the size class and updated to the allocated size.
+ * \return A pointer to the block or NULL on failure. */
+CVEC_HIDDEN void *cvec_cache_alloc(size_t *size);
+
+/** Frees a block, keeping it in the cache if it fits a size class exactly
+ * and the limits allow it.
+ * \param block A pointer to the block.
+ * \param size The allocated size of the block. */
+CVEC_HIDDEN void cvec_cache_free(void *block, size_t size);
+
+/** Function processing the indices [begin, end) of a parallel loop. */
+typedef void (*cvec_parallel_fn)(void *ctx, size_t begin, size_t end);
+
+/** Runs fn over the range [0, count) split into contiguous chunks.
+ * \details The chunks are processed by up to CVEC_MAX_THREADS threads 
+ * (one of them the caller), and each chunk gets at least min_chunk 
+ * indices. Each thread touches only its own chunk, so freshly allocated 
+ * pages are first touched by the thread that processes them. Chunks whose
+ * thread cannot be started run on the calling thread.
+ * \param count The number of indices.
+ * \param min_chunk The minimum number of indices per chunk.
+ * \param fn The function processing a chunk.
+ * \param ctx The context passed to fn. */
+CVEC_HIDDEN void cvec_parallel_for(
+	size_t count, size_t min_chunk, cvec_parallel_fn fn, void *ctx);
+
+#endif
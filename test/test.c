@@ -1,6 +1,7 @@
 #include "cvec.h"
 #include <ctest.h>
 #include <string.h>
+#include <pthread.h>
 
 void test_cvec_new_size_len_capacity_del() {
 	cvec_t *vec = cvec_new(sizeof(int));
@@ -138,6 +139,526 @@ void test_cvec_replace_range_shrink() {
 	CTEST(!cvec_get_error());
 }
 
+void test_cvec_clone() {
+	cvec_t *vec = cvec_new(sizeof(int));
+	int arr[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+	cvec_append(vec, arr, 9, sizeof(int));
+	cvec_t *clone = cvec_clone(vec);
+	CTEST(cvec_len(clone) == 9);
+	CTEST(cvec_capacity(clone) == cvec_capacity(vec));
+	CTEST(cvec_view(clone, 0) != cvec_view(vec, 0));
+	CTEST(!memcmp(arr, cvec_view(clone, 0), 9 * sizeof(int)));
+	cvec_del(vec);
+	cvec_del(clone);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_snapshot() {
+	cvec_t *vec = cvec_new(sizeof(int));
+	int arr[] = {1, 2, 3};
+	cvec_append(vec, arr, 3, sizeof(int));
+	cvec_t *snapshot = cvec_snapshot(vec);
+	CTEST(cvec_view(snapshot, 0) == cvec_view(vec, 0));
+	int value = 4;
+	cvec_push_back(vec, &value, sizeof(int));
+	CTEST(cvec_view(snapshot, 0) != cvec_view(vec, 0));
+	CTEST(cvec_len(snapshot) == 3);
+	CTEST(cvec_len(vec) == 4);
+	CTEST(!memcmp(arr, cvec_view(snapshot, 0), 3 * sizeof(int)));
+	cvec_t *snapshot2 = cvec_snapshot(snapshot);
+	*(int*)cvec_ptr(snapshot2, 0) = 42;
+	CTEST(*(const int*)cvec_view(snapshot, 0) == 1);
+	CTEST(*(const int*)cvec_view(snapshot2, 0) == 42);
+	cvec_del(snapshot);
+	cvec_pop_front(snapshot2);
+	CTEST(*(const int*)cvec_view(snapshot2, 0) == 2);
+	cvec_del(snapshot2);
+	cvec_del(vec);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_new_aligned() {
+	cvec_t *vec = cvec_new_aligned(sizeof(double), 64);
+	for (size_t i = 0; i < 1000; i++) {
+		double value = (double)i;
+		cvec_push_back(vec, &value, sizeof(double));
+		CTEST((size_t)cvec_view(vec, 0) % 64 == 0);
+	}
+	for (size_t i = 0; i < 1000; i++)
+		CTEST(*(const double*)cvec_view(vec, i) == (double)i);
+	cvec_t *clone = cvec_clone(vec);
+	CTEST((size_t)cvec_view(clone, 0) % 64 == 0);
+	cvec_t *snapshot = cvec_snapshot(vec);
+	for (size_t i = 0; i < 990; i++) {
+		cvec_pop_back(snapshot);
+		CTEST((size_t)cvec_view(snapshot, 0) % 64 == 0);
+	}
+	CTEST(*(const double*)cvec_view(snapshot, 9) == 9.0);
+	cvec_del(snapshot);
+	cvec_del(clone);
+	cvec_del(vec);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_set_huge_pages() {
+	cvec_t *vec = cvec_new_aligned(sizeof(int), 4096);
+	cvec_set_huge_pages(vec, true);
+	for (int i = 0; i < 1 << 20; i++)
+		cvec_push_back(vec, &i, sizeof(int));
+	CTEST((size_t)cvec_view(vec, 0) % 4096 == 0);
+	CTEST(*(const int*)cvec_view(vec, (1 << 20) - 1) == (1 << 20) - 1);
+	cvec_del(vec);
+	CTEST(!cvec_get_error());
+}
+
+CVEC_STATIC_TYPEDEF(int, 8);
+
+void test_cvec_static_typedef() {
+	svint_8 vec;
+	svint_8_init(&vec);
+	CTEST(svint_8_capacity(&vec) == 8);
+	CTEST(svint_8_push_back(&vec, 3));
+	CTEST(svint_8_push_front(&vec, 1));
+	CTEST(svint_8_insert(&vec, 2, 1));
+	int arr[] = {4, 5, 6, 7, 8};
+	CTEST(svint_8_append(&vec, arr, 5));
+	CTEST(!svint_8_push_back(&vec, 9));
+	CTEST(!svint_8_append(&vec, arr, 1));
+	int exp[] = {1, 2, 3, 4, 5, 6, 7, 8};
+	CTEST(svint_8_len(&vec) == 8);
+	CTEST(!memcmp(exp, svint_8_view(&vec, 0), sizeof(exp)));
+	CTEST(!svint_8_view(&vec, 8));
+	CTEST(svint_8_remove(&vec, 0));
+	CTEST(svint_8_pop_front(&vec));
+	CTEST(svint_8_pop_back(&vec));
+	int new_arr[] = {42};
+	CTEST(svint_8_replace_range(&vec, 1, new_arr, 1, 2));
+	int exp2[] = {3, 42, 6, 7};
+	CTEST(svint_8_len(&vec) == 4);
+	CTEST(!memcmp(exp2, svint_8_view(&vec, 0), sizeof(exp2)));
+	cvec_t *heap = svint_8_to_cvec(&vec);
+	CTEST(cvec_len(heap) == 4);
+	CTEST(!memcmp(exp2, cvec_view(heap, 0), sizeof(exp2)));
+	cvec_del(heap);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_bits_push_get_set() {
+	cvec_bits_t *bits = cvec_bits_new();
+	for (size_t i = 0; i < 200; i++)
+		cvec_bits_push_back(bits, i % 3 == 0);
+	CTEST(cvec_bits_len(bits) == 200);
+	for (size_t i = 0; i < 200; i++)
+		CTEST(cvec_bits_get(bits, i) == (i % 3 == 0));
+	cvec_bits_set(bits, 1, true);
+	cvec_bits_set(bits, 0, false);
+	CTEST(cvec_bits_get(bits, 1));
+	CTEST(!cvec_bits_get(bits, 0));
+	cvec_bits_pop_back(bits);
+	CTEST(cvec_bits_len(bits) == 199);
+	uint64_t words[] = {0xffffffffffffffffull, 0x5ull};
+	cvec_bits_append(bits, words, 67);
+	CTEST(cvec_bits_len(bits) == 266);
+	for (size_t i = 199; i < 263; i++)
+		CTEST(cvec_bits_get(bits, i));
+	CTEST(cvec_bits_get(bits, 263));
+	CTEST(!cvec_bits_get(bits, 264));
+	CTEST(cvec_bits_get(bits, 265));
+	CTEST(cvec_bits_popcount(bits) == 67 + 66);
+	cvec_bits_del(bits);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_bits_popcount_rank_select() {
+	cvec_bits_t *bits = cvec_bits_new();
+	for (size_t i = 0; i < 1000; i++)
+		cvec_bits_push_back(bits, i % 7 == 3);
+	CTEST(cvec_bits_popcount(bits) == 143);
+	CTEST(cvec_bits_find_first_set(bits) == 3);
+	CTEST(cvec_bits_find_next_set(bits, 4) == 10);
+	CTEST(cvec_bits_find_next_set(bits, 998) == (size_t)-1);
+	CTEST(cvec_bits_rank(bits, 0) == 0);
+	CTEST(cvec_bits_rank(bits, 4) == 1);
+	CTEST(cvec_bits_rank(bits, 1000) == 143);
+	for (size_t n = 0; n < 143; n++)
+		CTEST(cvec_bits_select(bits, n) == n * 7 + 3);
+	CTEST(cvec_bits_select(bits, 143) == (size_t)-1);
+	cvec_bits_del(bits);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_bits_bulk() {
+	cvec_bits_t *a = cvec_bits_new();
+	cvec_bits_t *b = cvec_bits_new();
+	for (size_t i = 0; i < 300; i++) {
+		cvec_bits_push_back(a, i % 2 == 0);
+		cvec_bits_push_back(b, i % 3 == 0);
+	}
+	cvec_bits_and(a, b);
+	CTEST(cvec_bits_popcount(a) == 50);
+	cvec_bits_or(a, b);
+	CTEST(cvec_bits_popcount(a) == 100);
+	cvec_bits_xor(a, b);
+	CTEST(cvec_bits_popcount(a) == 0);
+	cvec_bits_or(a, b);
+	cvec_bits_andnot(a, b);
+	CTEST(cvec_bits_popcount(a) == 0);
+	cvec_bits_del(a);
+	cvec_bits_del(b);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_compress_sorted() {
+	cvec_t *vec = cvec_new(sizeof(int64_t));
+	int64_t value = 1000000;
+	for (size_t i = 0; i < 10000; i++) {
+		value += (int64_t)(i % 13);
+		cvec_push_back(vec, &value, sizeof(int64_t));
+	}
+	cvec_compressed_t *c = cvec_compress(vec);
+	CTEST(cvec_compressed_len(c) == 10000);
+	CTEST(cvec_compressed_bytes(c) * 8 < cvec_len(vec) * sizeof(int64_t));
+	for (size_t i = 0; i < 10000; i++)
+		CTEST(cvec_compressed_get(c, i) == *(const int64_t*)cvec_view(vec, i));
+	int64_t buf[CVEC_COMPRESSED_BLOCK_LEN];
+	size_t index = 0, n;
+	while ((n = cvec_compressed_decode(c, index, buf, CVEC_COMPRESSED_BLOCK_LEN))) {
+		CTEST(!memcmp(buf, cvec_view(vec, index), n * sizeof(int64_t)));
+		index += n;
+	}
+	CTEST(index == 10000);
+	CTEST(cvec_compressed_decode(c, 100, buf, 50) == 50);
+	CTEST(!memcmp(buf, cvec_view(vec, 100), 50 * sizeof(int64_t)));
+	cvec_t *out = cvec_decompress(c);
+	CTEST(cvec_len(out) == 10000);
+	CTEST(!memcmp(cvec_view(out, 0), cvec_view(vec, 0), 10000 * sizeof(int64_t)));
+	cvec_del(out);
+	cvec_compressed_del(c);
+	cvec_del(vec);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_compress_extremes() {
+	cvec_t *vec = cvec_new(sizeof(int64_t));
+	int64_t arr[] = {INT64_MIN, INT64_MAX, 0, -1, 5, 5, 5};
+	cvec_append(vec, arr, 7, sizeof(int64_t));
+	for (int64_t i = 0; i < 300; i++) {
+		int64_t value = i % 2 ? -i * 1000 : i;
+		cvec_push_back(vec, &value, sizeof(int64_t));
+	}
+	cvec_compressed_t *c = cvec_compress(vec);
+	for (size_t i = 0; i < cvec_len(vec); i++)
+		CTEST(cvec_compressed_get(c, i) == *(const int64_t*)cvec_view(vec, i));
+	cvec_t *out = cvec_decompress(c);
+	CTEST(!memcmp(cvec_view(out, 0), cvec_view(vec, 0), cvec_len(vec) * sizeof(int64_t)));
+	cvec_del(out);
+	cvec_compressed_del(c);
+	cvec_del(vec);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_cache() {
+	cvec_t *before = cvec_new(sizeof(int));
+	cvec_cache_set_limits(1 << 20, 16);
+	cvec_del(before);
+	cvec_t *during = cvec_new(sizeof(int));
+	cvec_t *vec = cvec_new(sizeof(int));
+	int arr[] = {1, 2, 3};
+	cvec_append(vec, arr, 3, sizeof(int));
+	const void *data = cvec_view(vec, 0);
+	cvec_del(vec);
+	CTEST(cvec_cache_size() > 0);
+	vec = cvec_new(sizeof(int));
+	cvec_append(vec, arr, 3, sizeof(int));
+	CTEST(cvec_view(vec, 0) == data);
+	for (int i = 0; i < 1000; i++)
+		cvec_push_back(vec, &i, sizeof(int));
+	for (int i = 0; i < 1000; i++)
+		cvec_pop_back(vec);
+	CTEST(!memcmp(arr, cvec_view(vec, 0), sizeof(arr)));
+	cvec_del(vec);
+	CTEST(cvec_cache_size() <= 1 << 20);
+	cvec_cache_set_limits(64, 16);
+	CTEST(cvec_cache_size() <= 64);
+	cvec_cache_trim();
+	CTEST(cvec_cache_size() == 0);
+	cvec_cache_set_limits(0, 0);
+	cvec_del(during);
+	CTEST(!cvec_get_error());
+}
+
+static void *cache_and_exit(void *cached_bytes) {
+	cvec_cache_set_limits(1 << 20, 16);
+	for (int i = 0; i < 10; i++) {
+		cvec_t *vec = cvec_new(sizeof(int));
+		cvec_push_back(vec, &i, sizeof(int));
+		cvec_del(vec);
+	}
+	*(size_t*)cached_bytes = cvec_cache_size();
+	return NULL;
+}
+
+void test_cvec_cache_thread_exit() {
+	/* The blocks cached by the thread are freed by its exit destructor; 
+	 * the leak sanitizer would report them otherwise. */
+	size_t cached_bytes = 0;
+	pthread_t thread;
+	CTEST(!pthread_create(&thread, NULL, cache_and_exit, &cached_bytes));
+	pthread_join(thread, NULL);
+	CTEST(cached_bytes > 0);
+	CTEST(cvec_cache_size() == 0);
+	CTEST(!cvec_get_error());
+}
+
+static size_t hash_int(const void *key) {
+	return (size_t)*(const int*)key;
+}
+
+static bool eq_int(const void *a, const void *b) {
+	return *(const int*)a == *(const int*)b;
+}
+
+void test_cvec_map_insert_view_remove() {
+	cvec_map_t *map = cvec_map_new(sizeof(int), sizeof(size_t), hash_int, eq_int);
+	CTEST(cvec_map_len(map) == 0);
+	for (int i = 0; i < 1000; i++) {
+		size_t value = (size_t)i * 2;
+		CTEST(cvec_map_insert(map, &i, &value, sizeof(int), sizeof(size_t)));
+	}
+	CTEST(cvec_map_len(map) == 1000);
+	CTEST(cvec_map_capacity(map) * 7 / 8 >= 1000);
+	for (int i = 0; i < 1000; i++)
+		CTEST(*(const size_t*)cvec_map_view(map, &i) == (size_t)i * 2);
+	int key = 5;
+	size_t value = 42;
+	CTEST(!cvec_map_insert(map, &key, &value, sizeof(int), sizeof(size_t)));
+	CTEST(*(const size_t*)cvec_map_view(map, &key) == 42);
+	for (int i = 0; i < 1000; i += 2)
+		CTEST(cvec_map_remove(map, &i));
+	CTEST(cvec_map_len(map) == 500);
+	for (int i = 0; i < 1000; i++)
+		CTEST(cvec_map_contains(map, &i) == (i % 2 == 1));
+	key = 1000;
+	CTEST(!cvec_map_view(map, &key));
+	CTEST(!cvec_map_remove(map, &key));
+	size_t iter = 0, count = 0;
+	const void *k, *v;
+	while (cvec_map_next(map, &iter, &k, &v)) {
+		CTEST(*(const int*)k % 2 == 1);
+		count++;
+	}
+	CTEST(count == 500);
+	cvec_map_clear(map);
+	CTEST(cvec_map_len(map) == 0);
+	cvec_map_del(map);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_map_reserve_rehash() {
+	cvec_map_t *map = cvec_map_new(sizeof(int), 0, NULL, NULL);
+	cvec_map_reserve(map, 500);
+	size_t capacity = cvec_map_capacity(map);
+	CTEST(capacity * 7 / 8 >= 500);
+	for (int i = 0; i < 500; i++)
+		cvec_map_insert(map, &i, NULL, sizeof(int), 0);
+	CTEST(cvec_map_capacity(map) == capacity);
+	/* Churn through tombstones without growing. */
+	for (int i = 500; i < 5000; i++) {
+		int old = i - 500;
+		cvec_map_remove(map, &old);
+		cvec_map_insert(map, &i, NULL, sizeof(int), 0);
+	}
+	CTEST(cvec_map_len(map) == 500);
+	CTEST(cvec_map_capacity(map) == capacity);
+	cvec_map_rehash(map, capacity * 4);
+	CTEST(cvec_map_capacity(map) == capacity * 4);
+	for (int i = 4500; i < 5000; i++)
+		CTEST(cvec_map_contains(map, &i));
+	cvec_map_del(map);
+	CTEST(!cvec_get_error());
+}
+
+CVEC_MAP_TYPEDEF(int, double);
+CVEC_SET_TYPEDEF(int);
+
+void test_cvec_map_typedef() {
+	mint_double *map = mint_double_new(NULL, NULL);
+	CTEST(mint_double_insert(map, 3, 1.5));
+	*mint_double_ptr(map, 3) += 1.0;
+	CTEST(*mint_double_view(map, 3) == 2.5);
+	CTEST(!mint_double_view(map, 4));
+	mint_double_del(map);
+	sint *set = sint_new(NULL, NULL);
+	CTEST(sint_insert(set, 7));
+	CTEST(!sint_insert(set, 7));
+	CTEST(sint_contains(set, 7));
+	CTEST(sint_len(set) == 1);
+	sint_del(set);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_dedup() {
+	cvec_t *vec = cvec_new(sizeof(int));
+	int arr[] = {3, 1, 3, 2, 1, 4, 2};
+	int exp[] = {3, 1, 2, 4};
+	cvec_append(vec, arr, 7, sizeof(int));
+	cvec_dedup(vec, NULL, NULL);
+	CTEST(cvec_len(vec) == 4);
+	CTEST(!memcmp(exp, cvec_view(vec, 0), 4 * sizeof(int)));
+	cvec_del(vec);
+	CTEST(!cvec_get_error());
+}
+
+CVEC_TYPEDEF(int);
+
+void test_cvec_resize_assign_fill() {
+	struct pair {int a; short b;};
+	cvec_t *vec = cvec_new(sizeof(struct pair));
+	struct pair value = {0x12345678, 7};
+	cvec_resize(vec, 10000, &value, sizeof(struct pair));
+	CTEST(cvec_len(vec) == 10000);
+	bool is_filled = true;
+	for (size_t i = 0; i < 10000; i++) {
+		const struct pair *item = cvec_view(vec, i);
+		if (item->a != value.a || item->b != value.b) is_filled = false;
+	}
+	CTEST(is_filled);
+	cvec_resize(vec, 10, &value, sizeof(struct pair));
+	CTEST(cvec_len(vec) == 10);
+	CTEST(cvec_capacity(vec) == 16);
+	cvec_resize(vec, 20, NULL, sizeof(struct pair));
+	CTEST(((const struct pair*)cvec_view(vec, 9))->a == value.a);
+	CTEST(((const struct pair*)cvec_view(vec, 10))->a == 0);
+	CTEST(((const struct pair*)cvec_view(vec, 19))->b == 0);
+	cvec_del(vec);
+
+	vint *ints = vint_new();
+	vint_assign(ints, 100000, -1);
+	CTEST(vint_len(ints) == 100000);
+	CTEST(*vint_view(ints, 99999) == -1);
+	vint_fill_range(ints, 10, 5, 3);
+	CTEST(*vint_view(ints, 9) == -1);
+	CTEST(*vint_view(ints, 10) == 3);
+	CTEST(*vint_view(ints, 14) == 3);
+	CTEST(*vint_view(ints, 15) == -1);
+	vint *copy = vint_clone(ints);
+	vint_fill_range(copy, 0, 100000, 5);
+	CTEST(*vint_view(copy, 50000) == 5);
+	CTEST(*vint_view(ints, 50000) == -1);
+	vint *snapshot = vint_snapshot(ints);
+	vint_assign(ints, 100000, 9);
+	CTEST(*vint_view(ints, 0) == 9);
+	CTEST(*vint_view(snapshot, 0) == -1);
+	vint_assign(snapshot, 20, 4);
+	CTEST(vint_len(snapshot) == 20);
+	CTEST(vint_capacity(snapshot) == 32);
+	CTEST(*vint_view(snapshot, 19) == 4);
+	vint_del(snapshot);
+	vint_resize(ints, 0, 0);
+	CTEST(vint_len(ints) == 0);
+	CTEST(vint_capacity(ints) == 8);
+	vint_del(copy);
+	vint_del(ints);
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_gather_scatter() {
+	size_t sizes[] = {1, 4, 8, 16, 24};
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		size_t size = sizes[s];
+		unsigned char item[24];
+		cvec_t *src = cvec_new(size);
+		for (size_t i = 0; i < 5000; i++) {
+			memset(item, (int)(i % 251), size);
+			cvec_push_back(src, item, size);
+		}
+		size_t idx[5000];
+		for (size_t i = 0; i < 5000; i++)
+			idx[i] = i * 7 % 5000;
+		cvec_t *dst = cvec_new(size);
+		cvec_gather(dst, src, idx, 5000);
+		CTEST(cvec_len(dst) == 5000);
+		bool is_gathered = true;
+		for (size_t i = 0; i < 5000; i++)
+			if (memcmp(cvec_view(dst, i), cvec_view(src, idx[i]), size))
+				is_gathered = false;
+		CTEST(is_gathered);
+		cvec_t *back = cvec_new(size);
+		cvec_resize(back, 5000, NULL, size);
+		cvec_scatter(back, dst, idx);
+		bool is_scattered = true;
+		for (size_t i = 0; i < 5000; i++)
+			if (memcmp(cvec_view(back, i), cvec_view(src, i), size))
+				is_scattered = false;
+		CTEST(is_scattered);
+		cvec_gather(dst, src, idx, 3);
+		CTEST(cvec_len(dst) == 3);
+		cvec_del(back);
+		cvec_del(dst);
+		cvec_del(src);
+	}
+	CTEST(!cvec_get_error());
+}
+
+void test_cvec_permute() {
+	vint *ints = vint_new();
+	for (int i = 0; i < 2000; i++)
+		vint_push_back(ints, i * 3);
+	vint *copy = vint_snapshot(ints);
+	size_t perm[2000];
+	for (size_t i = 0; i < 2000; i++)
+		perm[i] = 1999 - i;
+	vint_permute(ints, perm);
+	CTEST(vint_len(ints) == 2000);
+	CTEST(*vint_view(ints, 0) == 1999 * 3);
+	CTEST(*vint_view(ints, 1999) == 0);
+	bool is_permuted = true;
+	for (size_t i = 0; i < 2000; i++)
+		if (*vint_view(ints, i) != (int)perm[i] * 3) is_permuted = false;
+	CTEST(is_permuted);
+	CTEST(*vint_view(copy, 0) == 0);
+	vint_del(copy);
+	vint_del(ints);
+	CTEST(!cvec_get_error());
+}
+
+static void *overflow_checks(void *unused) {
+	(void)unused;
+	cvec_t *vec = cvec_new(sizeof(uint64_t));
+	uint64_t value = 1;
+	cvec_push_back(vec, &value, sizeof(uint64_t));
+	cvec_resize(vec, ((size_t)1 << 61) + 1, &value, sizeof(uint64_t));
+	CTEST(cvec_get_error() != NULL);
+	CTEST(cvec_len(vec) == 1);
+	cvec_resize(vec, SIZE_MAX / 2 + 2, &value, sizeof(uint64_t));
+	CTEST(cvec_len(vec) == 1);
+	cvec_assign(vec, SIZE_MAX, &value, sizeof(uint64_t));
+	CTEST(cvec_len(vec) == 1);
+	cvec_append(vec, &value, SIZE_MAX, sizeof(uint64_t));
+	CTEST(cvec_len(vec) == 1);
+	CTEST(*(const uint64_t*)cvec_view(vec, 0) == 1);
+	cvec_del(vec);
+	cvec_map_t *map = cvec_map_new(sizeof(int), sizeof(double), NULL, NULL);
+	size_t capacity = cvec_map_capacity(map);
+	cvec_map_reserve(map, SIZE_MAX);
+	cvec_map_rehash(map, SIZE_MAX);
+	cvec_map_rehash(map, SIZE_MAX / 4);
+	CTEST(cvec_map_capacity(map) == capacity);
+	cvec_map_del(map);
+	return NULL;
+}
+
+void test_cvec_overflow() {
+	/* The errors are raised on another thread so they do not leak into the
+	 * error state checked by the other tests. */
+	pthread_t thread;
+	int failed = pthread_create(&thread, NULL, overflow_checks, NULL);
+	if (!failed)
+		pthread_join(thread, NULL);
+	CTEST(!failed);
+	CTEST(!cvec_get_error());
+}
+
 int main(void) {
 	test_cvec_new_size_len_capacity_del();
 	test_cvec_push_and_pop_back();
@@ -148,6 +669,26 @@ int main(void) {
 	test_cvec_replace();
 	test_cvec_replace_range_expand();
 	test_cvec_replace_range_shrink();
+	test_cvec_clone();
+	test_cvec_snapshot();
+	test_cvec_new_aligned();
+	test_cvec_set_huge_pages();
+	test_cvec_static_typedef();
+	test_cvec_bits_push_get_set();
+	test_cvec_bits_popcount_rank_select();
+	test_cvec_bits_bulk();
+	test_cvec_compress_sorted();
+	test_cvec_compress_extremes();
+	test_cvec_cache();
+	test_cvec_cache_thread_exit();
+	test_cvec_resize_assign_fill();
+	test_cvec_gather_scatter();
+	test_cvec_permute();
+	test_cvec_overflow();
+	test_cvec_map_insert_view_remove();
+	test_cvec_map_reserve_rehash();
+	test_cvec_map_typedef();
+	test_cvec_dedup();
 
 	ctest_print_results();
 	return 0;
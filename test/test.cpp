@@ -0,0 +1,133 @@
+#include "cvec.hpp"
+extern "C" {
+#include <ctest.h>
+}
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+void test_vector_raii_and_moves() {
+	cvec::vector<int> vec{3, 1, 2};
+	CTEST(vec.size() == 3);
+	cvec_t *handle = vec.get();
+	cvec::vector<int> moved(std::move(vec));
+	CTEST(moved.get() == handle);
+	CTEST(!vec.get());
+	vec = std::move(moved);
+	CTEST(vec.get() == handle);
+	cvec::vector<int> copy(vec);
+	CTEST(copy.get() != vec.get());
+	CTEST(std::equal(copy.begin(), copy.end(), vec.begin()));
+	vec.push_back(4);
+	CTEST(copy.size() == 3);
+	CTEST(vec.size() == 4);
+	CTEST(!cvec_get_error());
+}
+
+void test_vector_algorithms() {
+	cvec::vector<int> vec;
+	for (int i = 100; i > 0; i--)
+		vec.push_back(i);
+	std::sort(vec.begin(), vec.end());
+	CTEST(std::is_sorted(vec.begin(), vec.end()));
+	CTEST(std::accumulate(vec.cbegin(), vec.cend(), 0) == 5050);
+	int sum = 0;
+	for (int value : vec)
+		sum += value;
+	CTEST(sum == 5050);
+	CTEST(*vec.rbegin() == 100);
+	CTEST(vec.at(0) == 1);
+	bool thrown = false;
+	try {
+		vec.at(100);
+	} catch (const std::out_of_range &) {
+		thrown = true;
+	}
+	CTEST(thrown);
+#ifdef __cpp_lib_span
+	std::span<const int> span = std::as_const(vec);
+	CTEST(span.size() == 100);
+	CTEST(span[99] == 100);
+#endif
+	CTEST(!cvec_get_error());
+}
+
+void test_vector_c_interop() {
+	cvec_t *handle = cvec_new(sizeof(double));
+	double value = 1.5;
+	cvec_push_back(handle, &value, sizeof(double));
+	cvec::vector<double> vec(handle);
+	vec.push_back(2.5);
+	CTEST(vec[1] == 2.5);
+	CTEST(cvec_len(vec.get()) == 2);
+	cvec::vector<double> snapshot = vec.snapshot();
+	vec[0] = 0.0;
+	CTEST(snapshot[0] == 1.5);
+	CTEST(std::as_const(snapshot).data() != std::as_const(vec).data());
+	CTEST(snapshot.size() == cvec_len(snapshot.get()));
+	cvec_t *released = vec.release();
+	CTEST(!vec.get());
+	cvec_del(released);
+	CTEST(!cvec_get_error());
+}
+
+void test_vector_resize_assign() {
+	cvec::vector<long> v;
+	v.resize(1000, 7);
+	CTEST(v.size() == 1000);
+	CTEST(v[999] == 7);
+	v.fill_range(100, 10, -1);
+	CTEST(v[99] == 7 && v[100] == -1 && v[109] == -1 && v[110] == 7);
+	v.assign(3, 2);
+	CTEST(v.size() == 3 && v[0] == 2 && v[2] == 2);
+	v.clear();
+	CTEST(v.empty());
+	for (long i = 0; i < 4; i++)
+		v.push_back(i);
+	std::size_t perm[] = {3, 2, 1, 0};
+	v.permute(perm);
+	CTEST(v[0] == 3 && v[3] == 0);
+	cvec::vector<long> w;
+	w.gather(v, perm, 2);
+	CTEST(w.size() == 2 && w[0] == 0 && w[1] == 1);
+}
+
+void test_vector_self_reference() {
+	cvec::vector<long> v;
+	for (long i = 0; i < 8; i++)
+		v.push_back(i * 10);
+	CTEST(v.size() == v.capacity());
+	v.push_back(v[3]);
+	CTEST(v.size() == 9 && v[8] == 30);
+	v.push_front(v[8]);
+	CTEST(v.front() == 30);
+	v.insert(1, v[8]);
+	CTEST(v[1] == 70);
+	v.resize(100, v[1]);
+	CTEST(v[99] == 70);
+	v.fill_range(0, 2, v[50]);
+	CTEST(v[0] == 70 && v[1] == 70);
+	v.assign(1000, v[3]);
+	CTEST(v.size() == 1000 && v[999] == 10);
+	v.resize(8);
+	for (long i = 0; i < 8; i++)
+		v[i] = i;
+	v.append(v.data(), v.size());
+	CTEST(v.size() == 16 && v[8] == 0 && v[15] == 7);
+	v.prepend(v.data() + 14, 2);
+	CTEST(v.size() == 18 && v[0] == 6 && v[1] == 7 && v[2] == 0);
+	v.replace_range(0, v.data() + 2, 16, 2);
+	CTEST(v.size() == 32 && v[0] == 0 && v[15] == 7 && v[16] == 0);
+	CTEST(!cvec_get_error());
+}
+
+int main(void) {
+	test_vector_raii_and_moves();
+	test_vector_algorithms();
+	test_vector_c_interop();
+	test_vector_resize_assign();
+	test_vector_self_reference();
+
+	ctest_print_results();
+	return 0;
+}